@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+#include "Side.h"
+#include "Usings.h"
+
+// The state of one price level after a command. A quantity of zero means the
+// level is gone.
+struct LevelChange
+{
+    Side side_;
+    Price price_;
+    Quantity quantity_;
+    Quantity count_;
+};
+
+using LevelChanges = std::vector<LevelChange>;
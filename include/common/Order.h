@@ -34,6 +34,20 @@ public:
             throw std::logic_error(std::format("Order ({}) cannot be filled for more than its remaining quantity.", GetOrderId()));
         remainingQuantity_ -= quantity;
     }
+    void Reduce(Quantity quantity)
+    {
+        if (quantity > GetRemainingQuantity())
+            throw std::logic_error(std::format("Order ({}) cannot be reduced by more than its remaining quantity.", GetOrderId()));
+        initialQuantity_ -= quantity;
+        remainingQuantity_ -= quantity;
+    }
+    void Replace(Side side, Price price, Quantity quantity)
+    {
+        side_ = side;
+        price_ = price;
+        initialQuantity_ = quantity;
+        remainingQuantity_ = quantity;
+    }
 
 private:
     OrderType orderType_;
@@ -3,5 +3,8 @@
 enum class OrderType
 {
     GoodTillCancel,
-    FillAndKill
+    FillAndKill,
+    FillOrKill,
+    PostOnly,
+    Market
 };
\ No newline at end of file
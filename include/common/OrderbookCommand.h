@@ -0,0 +1,24 @@
+#pragma once
+
+#include "OrderType.h"
+#include "Side.h"
+#include "Usings.h"
+
+// One book operation in a form that can be queued and replayed. Cancel uses
+// only orderId_; Modify ignores orderType_ and keeps the resting order's type.
+struct OrderbookCommand
+{
+    enum class Action
+    {
+        Add,
+        Cancel,
+        Modify,
+    };
+
+    Action action_;
+    OrderType orderType_;
+    OrderId orderId_;
+    Side side_;
+    Price price_;
+    Quantity quantity_;
+};
@@ -1,13 +1,15 @@
 #pragma once
 
+#include <utility>
+
 #include "LevelInfo.h"
 
 class OrderbookLevelInfos
 {
 public:
-    OrderbookLevelInfos(const LevelInfos& bids, const LevelInfos& asks)
-        : bids_{ bids }
-        , asks_{ asks }
+    OrderbookLevelInfos(LevelInfos bids, LevelInfos asks)
+        : bids_{ std::move(bids) }
+        , asks_{ std::move(asks) }
     { }
 
     const LevelInfos& GetBids() const { return bids_; }
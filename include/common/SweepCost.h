@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Usings.h"
+
+// What taking a quantity from one side of the book would cost, level by level.
+struct SweepCost
+{
+    // Short of the quantity asked for when the side is too thin.
+    std::uint64_t quantity_{ };
+    // Price times quantity, summed over the levels taken from.
+    std::int64_t notional_{ };
+    Price worstPrice_{ };
+
+    // The volume-weighted average price, or zero if nothing is available.
+    double AveragePrice() const { return quantity_ ? static_cast<double>(notional_) / quantity_ : 0.0; }
+};
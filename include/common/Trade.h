@@ -5,17 +5,18 @@
 class Trade
 {
 public:
-    Trade(const TradeInfo& bidTrade, const TradeInfo& askTrade)
+    Trade() = default;
+    constexpr Trade(const TradeInfo& bidTrade, const TradeInfo& askTrade)
         : bidTrade_{ bidTrade }
         , askTrade_{ askTrade }
     { }
 
-    const TradeInfo& GetBidTrade() const { return bidTrade_; }
-    const TradeInfo& GetAskTrade() const { return askTrade_; }
+    constexpr const TradeInfo& GetBidTrade() const { return bidTrade_; }
+    constexpr const TradeInfo& GetAskTrade() const { return askTrade_; }
 
 private:
-    TradeInfo bidTrade_;
-    TradeInfo askTrade_;
+    TradeInfo bidTrade_{ };
+    TradeInfo askTrade_{ };
 };
 
 using Trades = std::vector<Trade>;
\ No newline at end of file
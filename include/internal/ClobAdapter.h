@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <Side.h>
+#include <Usings.h>
+
+#include "ExchangeAdapter.h"
+#include "JsonScanner.h"
+
+// Central-limit-order-book venues in the Polymarket style, which quote one
+// outcome token per book with decimal prices and sizes as strings:
+//   {"market":"...","asset_id":"...","bids":[{"price":"0.48","size":"30"}],"asks":[...]}
+// Prices are converted to ticks of 1/ticksPerUnit and must lie on that grid;
+// sizes are converted to lots of 1/lotsPerUnit with finer digits dropped, and
+// levels that round down to nothing are skipped.
+class ClobDecoder : JsonScanner {
+public:
+    static constexpr std::string_view DefaultEndpoint = "https://clob.polymarket.com/";
+
+    explicit ClobDecoder(std::int64_t ticksPerUnit = 100, std::int64_t lotsPerUnit = 1)
+        : ticksPerUnit_(ticksPerUnit)
+        , lotsPerUnit_(lotsPerUnit) {}
+
+    void buildOrderbookUrl(std::string& url, const std::string& endpoint, const std::string& ticker) const {
+        url.assign(endpoint).append("book?token_id=").append(ticker);
+    }
+
+    template <typename Handler>
+    bool decode(std::string_view body, Handler&& handler, const char*& error) const {
+        Cursor cursor{body.data(), body.data() + body.size(), nullptr};
+        bool foundLevels = false;
+
+        if (!parseObject(cursor, [&](std::string_view key) {
+                if (key == "bids" || key == "asks") {
+                    foundLevels = true;
+                    return parseLevels(cursor, key == "bids" ? Side::Buy : Side::Sell, handler);
+                }
+                return skipValue(cursor);
+            })) {
+            error = cursor.error ? cursor.error : "Malformed orderbook JSON";
+            return false;
+        }
+
+        if (!foundLevels) {
+            error = "Invalid response: missing orderbook data";
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    template <typename Handler>
+    bool parseLevels(Cursor& cursor, Side side, Handler& handler) const {
+        if (!peek(cursor, '[')) {
+            return skipValue(cursor);
+        }
+
+        return parseArray(cursor, [&] {
+            std::int64_t price = -1;
+            std::int64_t quantity = -1;
+            if (!parseObject(cursor, [&](std::string_view key) {
+                    if (key == "price") {
+                        return readDecimal(cursor, ticksPerUnit_, false, price);
+                    }
+                    if (key == "size") {
+                        return readDecimal(cursor, lotsPerUnit_, true, quantity);
+                    }
+                    return skipValue(cursor);
+                })) {
+                return false;
+            }
+            if (price < 0 || quantity < 0) {
+                cursor.error = "Orderbook level is missing its price or size";
+                return false;
+            }
+            if (price > std::numeric_limits<Price>::max() || quantity > std::numeric_limits<Quantity>::max()) {
+                cursor.error = "Orderbook level out of range";
+                return false;
+            }
+            if (quantity > 0) {
+                handler(side, static_cast<Price>(price), static_cast<Quantity>(quantity));
+            }
+            return true;
+        });
+    }
+
+    std::int64_t ticksPerUnit_;
+    std::int64_t lotsPerUnit_;
+};
+
+using ClobAdapter = BasicExchangeAdapter<ClobDecoder>;
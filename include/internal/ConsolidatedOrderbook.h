@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <LevelInfo.h>
+#include <OrderbookLevelInfos.h>
+#include <Side.h>
+#include <Usings.h>
+
+#include "LevelOrderbook.h"
+#include "PriceLevels.h"
+
+// Aggregated depth of one binary market across several source books, for
+// example Kalshi and a CLOB venue's YES and NO token books. Each source keeps
+// its own levels; the consolidated ladders hold the sum over sources per
+// price and are adjusted by the difference whenever a source level changes,
+// so the best bid and ask are read in constant time and never rebuilt.
+class ConsolidatedOrderbook
+{
+public:
+    using SourceId = std::size_t;
+
+private:
+    struct Level
+    {
+        Quantity quantity_{ };
+    };
+
+    struct Source
+    {
+        LevelOrderbook levels_;
+        bool complement_{ };
+    };
+
+    std::vector<std::unique_ptr<Source>> sources_;
+    ArrayLevels<>::Ladder<Level, Side::Buy> bids_;
+    ArrayLevels<>::Ladder<Level, Side::Sell> asks_;
+
+    void Adjust(bool complement, Side side, Price price, Quantity previous, Quantity quantity);
+
+public:
+    ConsolidatedOrderbook();
+    ConsolidatedOrderbook(const ConsolidatedOrderbook&) = delete;
+    void operator=(const ConsolidatedOrderbook&) = delete;
+    ~ConsolidatedOrderbook();
+
+    // A complement source quotes the opposite outcome: its bid at p counts as
+    // an ask at 100 - p here, and its ask as a bid at 100 - p.
+    SourceId AddSource(bool complement = false);
+    std::size_t SourceCount() const;
+
+    // Sets one source level as it is quoted by that source. Returns false if
+    // the price is outside the book; throws std::out_of_range for an unknown source.
+    bool SetLevel(SourceId source, Side side, Price price, Quantity quantity);
+    void ClearSource(SourceId source);
+
+    // Brings a source in line with a full snapshot, touching only the levels
+    // whose quantity differs.
+    void ReplaceSource(SourceId source, const LevelOrderbook& orderbook);
+
+    Quantity GetLevel(Side side, Price price) const;
+    Quantity GetSourceLevel(SourceId source, Side side, Price price) const;
+    std::optional<LevelInfo> GetBestBid() const;
+    std::optional<LevelInfo> GetBestAsk() const;
+    bool IsCrossed() const;
+    std::size_t Size() const;
+    OrderbookLevelInfos GetTopOfBook(std::size_t depth) const;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <Usings.h>
+
+// How much of a quantity a walk through consecutive level quantities took.
+// Offsets count levels from where the walk started.
+struct QuantitySweep
+{
+    std::uint64_t quantity_{ };
+    // Sum of offset * quantity taken, so a walk from price p costs
+    // p * quantity_ + weightedOffset_ going up or p * quantity_ - weightedOffset_
+    // going down.
+    std::uint64_t weightedOffset_{ };
+    // The furthest level taken from; zero if nothing was taken.
+    std::size_t lastOffset_{ };
+};
+
+// Sweeps over a contiguous run of per-tick level quantities, as a price ladder
+// keeps them. Every set gives the same results; they differ only in the
+// instructions they use. Partial sums are 64-bit so no run of levels overflows.
+struct DepthKernels
+{
+    // Total of quantities.
+    std::uint64_t (*sum_)(std::span<const Quantity> quantities);
+    // sums[i] is total plus quantities[0..i].
+    void (*prefixSums_)(std::span<const Quantity> quantities, std::uint64_t* sums, std::uint64_t total);
+    // sums[i] is total plus quantities[i..n).
+    void (*suffixSums_)(std::span<const Quantity> quantities, std::uint64_t* sums, std::uint64_t total);
+    // Takes up to quantity level by level, from the first element or from the
+    // last one.
+    QuantitySweep (*sweepForward_)(std::span<const Quantity> quantities, std::uint64_t quantity);
+    QuantitySweep (*sweepBackward_)(std::span<const Quantity> quantities, std::uint64_t quantity);
+
+    static const DepthKernels& Scalar();
+    // Null unless the target is x86-64 and the CPU has AVX2.
+    static const DepthKernels* Avx2();
+    // AVX2 where available, otherwise scalar. Chosen once per process.
+    static const DepthKernels& Best();
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <LevelInfo.h>
+
+// Most levels per side a DepthPublisher can hold.
+inline constexpr std::size_t MaxPublishedDepth = 16;
+
+// A reader's copy of the published depth, best level first on each side.
+struct DepthSnapshot
+{
+    std::array<LevelInfo, MaxPublishedDepth> bids_;
+    std::array<LevelInfo, MaxPublishedDepth> asks_;
+    std::size_t bidCount_{ };
+    std::size_t askCount_{ };
+    // Number of changes published before this one was read.
+    std::uint64_t version_{ };
+
+    std::span<const LevelInfo> Bids() const { return { bids_.data(), bidCount_ }; }
+    std::span<const LevelInfo> Asks() const { return { asks_.data(), askCount_ }; }
+};
+
+// Publishes the top levels of one book from its owning thread to any number of
+// reader threads through a seqlock. The writer never waits for readers and
+// readers never allocate; a read that overlaps a write is detected by the
+// sequence number and retried. Every field is a relaxed atomic, so the
+// overlapping accesses are not data races.
+class DepthPublisher
+{
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+
+    std::size_t depth_;
+
+    // Writer-only copy of what was last published, so a change below the
+    // published depth leaves the shared lines, and the readers' caches, alone.
+    std::array<std::uint64_t, MaxPublishedDepth> lastBids_{ };
+    std::array<std::uint64_t, MaxPublishedDepth> lastAsks_{ };
+    std::uint64_t lastCounts_{ };
+
+    alignas(CacheLineSize) std::atomic<std::uint64_t> sequence_{ };
+    std::atomic<std::uint64_t> counts_{ };
+    std::array<std::atomic<std::uint64_t>, MaxPublishedDepth> bids_{ };
+    std::array<std::atomic<std::uint64_t>, MaxPublishedDepth> asks_{ };
+
+    static std::uint64_t Pack(const LevelInfo& level)
+    {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(level.price_)) << 32 | level.quantity_;
+    }
+
+    static LevelInfo Unpack(std::uint64_t packed)
+    {
+        return LevelInfo{ static_cast<Price>(static_cast<std::uint32_t>(packed >> 32)), static_cast<Quantity>(packed) };
+    }
+
+public:
+    explicit DepthPublisher(std::size_t depth = MaxPublishedDepth)
+        : depth_{ std::clamp<std::size_t>(depth, 1, MaxPublishedDepth) }
+    { }
+
+    DepthPublisher(const DepthPublisher&) = delete;
+    void operator=(const DepthPublisher&) = delete;
+
+    std::size_t Depth() const { return depth_; }
+
+    // Writer side, from the thread that owns the book. Levels past Depth() are
+    // ignored. Publishing the same levels again is a no-op.
+    void Publish(std::span<const LevelInfo> bids, std::span<const LevelInfo> asks)
+    {
+        std::size_t bidCount = std::min(bids.size(), depth_);
+        std::size_t askCount = std::min(asks.size(), depth_);
+        std::uint64_t counts = static_cast<std::uint64_t>(bidCount) << 32 | askCount;
+
+        bool changed = counts != lastCounts_;
+        for (std::size_t i = 0; i < bidCount; ++i)
+            changed |= Pack(bids[i]) != lastBids_[i];
+        for (std::size_t i = 0; i < askCount; ++i)
+            changed |= Pack(asks[i]) != lastAsks_[i];
+        if (!changed)
+            return;
+
+        auto sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < bidCount; ++i)
+        {
+            lastBids_[i] = Pack(bids[i]);
+            bids_[i].store(lastBids_[i], std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < askCount; ++i)
+        {
+            lastAsks_[i] = Pack(asks[i]);
+            asks_[i].store(lastAsks_[i], std::memory_order_relaxed);
+        }
+        lastCounts_ = counts;
+        counts_.store(counts, std::memory_order_relaxed);
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Reader side. Changes whenever new levels are published, so a reader can
+    // poll it before paying for a full read.
+    std::uint64_t Version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+    // One wait-free attempt. Returns false, leaving snapshot partly written, if
+    // a publish was in progress or completed during the read.
+    bool TryRead(DepthSnapshot& snapshot) const
+    {
+        auto before = sequence_.load(std::memory_order_acquire);
+        if (before & 1)
+            return false;
+
+        auto counts = counts_.load(std::memory_order_relaxed);
+        snapshot.bidCount_ = std::min<std::size_t>(counts >> 32, MaxPublishedDepth);
+        snapshot.askCount_ = std::min<std::size_t>(counts & 0xFFFFFFFF, MaxPublishedDepth);
+        for (std::size_t i = 0; i < snapshot.bidCount_; ++i)
+            snapshot.bids_[i] = Unpack(bids_[i].load(std::memory_order_relaxed));
+        for (std::size_t i = 0; i < snapshot.askCount_; ++i)
+            snapshot.asks_[i] = Unpack(asks_[i].load(std::memory_order_relaxed));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        snapshot.version_ = before / 2;
+        return sequence_.load(std::memory_order_relaxed) == before;
+    }
+
+    // Retries until it reads a consistent snapshot, so it only waits while the
+    // writer keeps publishing.
+    void Read(DepthSnapshot& snapshot) const
+    {
+        while (!TryRead(snapshot)) { }
+    }
+};
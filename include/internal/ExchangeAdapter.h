@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <OrderType.h>
+#include <Side.h>
+#include <Usings.h>
+
+#include "LevelOrderbook.h"
+#include "Orderbook.h"
+
+// Venue-specific half of the REST snapshot path: where a market's orderbook
+// lives and how its response body maps onto bid and ask levels in book ticks.
+// The feed handler makes one virtual call per response; the per-level work
+// runs inside the decoder with the book update inlined.
+class ExchangeAdapter {
+public:
+    virtual ~ExchangeAdapter() = default;
+
+    virtual std::string defaultEndpoint() const = 0;
+
+    virtual void buildOrderbookUrl(std::string& url, const std::string& endpoint, const std::string& ticker) const = 0;
+
+    // Sets each decoded level on the book. On failure returns false and points
+    // error at a static message.
+    virtual bool decodeOrderbook(std::string_view body, LevelOrderbook& orderbook, const char*& error) const = 0;
+
+    // Adds each decoded level to the book as one good-till-cancel order, with
+    // order ids counting up from 1.
+    virtual bool decodeOrderbook(std::string_view body, Orderbook& orderbook, const char*& error) const = 0;
+};
+
+// Implements ExchangeAdapter over a decoder exposing
+//   static constexpr std::string_view DefaultEndpoint;
+//   void buildOrderbookUrl(std::string& url, const std::string& endpoint, const std::string& ticker) const;
+//   template <typename Handler>
+//   bool decode(std::string_view body, Handler&& handler, const char*& error) const;
+// where decode calls handler(Side side, Price price, Quantity quantity) once
+// per level, already normalized to book prices.
+template <typename Decoder>
+class BasicExchangeAdapter final : public ExchangeAdapter {
+public:
+    explicit BasicExchangeAdapter(Decoder decoder = Decoder{}) : decoder_(std::move(decoder)) {}
+
+    const Decoder& decoder() const { return decoder_; }
+
+    std::string defaultEndpoint() const override {
+        return std::string(Decoder::DefaultEndpoint);
+    }
+
+    void buildOrderbookUrl(std::string& url, const std::string& endpoint, const std::string& ticker) const override {
+        decoder_.buildOrderbookUrl(url, endpoint, ticker);
+    }
+
+    bool decodeOrderbook(std::string_view body, LevelOrderbook& orderbook, const char*& error) const override {
+        return decoder_.decode(body, [&](Side side, Price price, Quantity quantity) {
+            orderbook.SetLevel(side, price, quantity);
+        }, error);
+    }
+
+    bool decodeOrderbook(std::string_view body, Orderbook& orderbook, const char*& error) const override {
+        OrderId orderId = 1;
+        return decoder_.decode(body, [&](Side side, Price price, Quantity quantity) {
+            orderbook.AddOrder(OrderType::GoodTillCancel, orderId++, side, price, quantity);
+        }, error);
+    }
+
+private:
+    Decoder decoder_;
+};
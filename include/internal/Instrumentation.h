@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include "LatencyHistogram.h"
+#include "Probes.h"
+
+// Reading back what the probes recorded: snapshots across threads, dumps and a
+// periodic dump thread. TakeMetricsSnapshot() returns an empty snapshot unless
+// built with MORNINGSIDE_INSTRUMENTATION.
+
+std::string_view ToString(LatencyProbe probe);
+std::string_view ToString(EventCounter counter);
+
+// Ticks per nanosecond, measured once against steady_clock on first use.
+double TicksPerNanosecond();
+
+// Totals across every thread at one moment. Histograms are kept in ticks and
+// converted to nanoseconds on query.
+class MetricsSnapshot
+{
+private:
+    std::array<LatencyHistogram, LatencyProbeCount> probes_{ };
+    std::array<std::uint64_t, EventCounterCount> counters_{ };
+    double ticksPerNanosecond_{ 1.0 };
+
+public:
+    MetricsSnapshot() = default;
+    explicit MetricsSnapshot(double ticksPerNanosecond) : ticksPerNanosecond_{ ticksPerNanosecond } { }
+
+    void Collect(const ThreadMetrics& metrics);
+
+    const LatencyHistogram& Histogram(LatencyProbe probe) const { return probes_[static_cast<std::size_t>(probe)]; }
+    std::uint64_t Samples(LatencyProbe probe) const { return Histogram(probe).Count(); }
+    double PercentileNanoseconds(LatencyProbe probe, double percentile) const
+    {
+        return Histogram(probe).Percentile(percentile) / ticksPerNanosecond_;
+    }
+    double MaxNanoseconds(LatencyProbe probe) const
+    {
+        return static_cast<double>(Histogram(probe).Max()) / ticksPerNanosecond_;
+    }
+
+    std::uint64_t Count(EventCounter counter) const { return counters_[static_cast<std::size_t>(counter)]; }
+};
+
+MetricsSnapshot TakeMetricsSnapshot();
+
+// Writes one line per probe with samples (count, p50, p99, p99.9, max in ns),
+// then the non-zero counters.
+void DumpMetrics(const MetricsSnapshot& snapshot, std::ostream& out);
+
+// Dumps a fresh snapshot to out every interval until destroyed.
+class PeriodicMetricsDump
+{
+private:
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_{ };
+    std::thread thread_;
+
+public:
+    PeriodicMetricsDump(std::chrono::milliseconds interval, std::ostream& out);
+    PeriodicMetricsDump(const PeriodicMetricsDump&) = delete;
+    void operator=(const PeriodicMetricsDump&) = delete;
+    ~PeriodicMetricsDump();
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <OrderbookCommand.h>
+#include <Trade.h>
+
+#include "MappedFile.h"
+#include "Orderbook.h"
+
+// Fixed-width journal entry. Commands use orderId_, side_, price_ and
+// quantity_; a trade stores the bid in orderId_/price_ and the ask in
+// counterOrderId_/counterPrice_. Fields are written in host byte order.
+struct JournalRecord
+{
+    enum class Type : std::uint8_t
+    {
+        Add,
+        Cancel,
+        Modify,
+        Trade,
+    };
+
+    Type type_;
+    std::uint8_t orderType_;
+    std::uint8_t side_;
+    std::uint8_t reserved_;
+    Price price_;
+    Quantity quantity_;
+    Price counterPrice_;
+    OrderId orderId_;
+    OrderId counterOrderId_;
+
+    static JournalRecord FromCommand(const OrderbookCommand& command);
+    static JournalRecord FromTrade(const Trade& trade);
+
+    // A type byte outside Type, as a corrupt or newer journal can hold, is
+    // neither a command nor a trade.
+    bool IsCommand() const { return type_ == Type::Add || type_ == Type::Cancel || type_ == Type::Modify; }
+    bool IsTrade() const { return type_ == Type::Trade; }
+    // Throws std::runtime_error unless IsCommand().
+    OrderbookCommand ToCommand() const;
+    Trade ToTrade() const;
+};
+
+static_assert(sizeof(JournalRecord) == 32);
+
+struct JournalHeader
+{
+    static constexpr std::uint64_t Magic = 0x4C4E524A42524F4Dull; // "MORBJRNL"
+    static constexpr std::uint32_t CurrentVersion = 1;
+
+    std::uint64_t magic_;
+    std::uint32_t version_;
+    std::uint32_t recordSize_;
+    std::uint64_t reserved_[2];
+};
+
+static_assert(sizeof(JournalHeader) == 32);
+
+enum class JournalSync
+{
+    None,    // leave write-back to the OS
+    OnFlush, // fsync after each buffered batch reaches the file
+    Always,  // write and fsync every record
+};
+
+// Appends records to a journal file through an in-memory buffer that is written
+// out when full, on Flush() and on destruction. Opening an existing journal
+// appends to it after dropping any partial trailing record. Throws
+// std::system_error on I/O failure and std::runtime_error if an existing file
+// is not a supported journal.
+class JournalWriter
+{
+private:
+    int fd_{ -1 };
+    JournalSync sync_;
+    std::vector<JournalRecord> buffer_;
+
+    void WriteBuffer();
+
+public:
+    explicit JournalWriter(const std::string& path, JournalSync sync = JournalSync::OnFlush, std::size_t bufferRecords = 4096);
+    JournalWriter(const JournalWriter&) = delete;
+    void operator=(const JournalWriter&) = delete;
+    ~JournalWriter();
+
+    void Append(const JournalRecord& record)
+    {
+        buffer_.push_back(record);
+        if (buffer_.size() == buffer_.capacity() || sync_ == JournalSync::Always)
+            Flush();
+    }
+
+    void Append(const OrderbookCommand& command) { Append(JournalRecord::FromCommand(command)); }
+    void Append(const Trade& trade) { Append(JournalRecord::FromTrade(trade)); }
+
+    // Lets the writer be passed directly as a trade sink.
+    void operator()(const Trade& trade) { Append(trade); }
+
+    // Writes buffered records, then fsyncs unless the policy is None.
+    void Flush();
+    // Writes buffered records and fsyncs regardless of policy.
+    void Sync();
+};
+
+// Maps a journal read-only. A partially written trailing record, as left by a
+// crash mid-write, is ignored. Throws std::system_error if the file cannot be
+// mapped and std::runtime_error if the header is not a supported journal.
+class JournalReader
+{
+private:
+    MappedFile file_;
+    std::span<const JournalRecord> records_;
+
+public:
+    explicit JournalReader(const std::string& path);
+
+    std::span<const JournalRecord> Records() const { return records_; }
+};
+
+struct JournalReplayStats
+{
+    std::size_t commands_{ };
+    std::size_t recordedTrades_{ };
+    std::size_t replayedTrades_{ };
+};
+
+// Rebuilds a book by re-applying the journaled commands in order. Trades are
+// regenerated by matching, so the recorded ones are only counted; a mismatch
+// between the two counts means the journal came from a different book state.
+// Throws std::runtime_error at the first record of an unknown type, after
+// applying every command before it.
+template <typename Levels>
+JournalReplayStats ReplayJournal(std::span<const JournalRecord> records, BasicOrderbook<Levels>& orderbook);
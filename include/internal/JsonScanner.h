@@ -0,0 +1,170 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+// Allocation-free JSON primitives shared by the venue-specific orderbook
+// scanners. Each one advances a cursor over the body in place and returns
+// false on malformed input, optionally leaving a static message in error.
+class JsonScanner {
+protected:
+    struct Cursor {
+        const char* pos;
+        const char* end;
+        const char* error;
+    };
+
+    static void skipWhitespace(Cursor& cursor) {
+        while (cursor.pos != cursor.end &&
+               (*cursor.pos == ' ' || *cursor.pos == '\n' || *cursor.pos == '\r' || *cursor.pos == '\t')) {
+            ++cursor.pos;
+        }
+    }
+
+    static bool peek(Cursor& cursor, char expected) {
+        skipWhitespace(cursor);
+        return cursor.pos != cursor.end && *cursor.pos == expected;
+    }
+
+    static bool consume(Cursor& cursor, char expected) {
+        if (!peek(cursor, expected)) {
+            return false;
+        }
+        ++cursor.pos;
+        return true;
+    }
+
+    static bool readString(Cursor& cursor, std::string_view& value) {
+        if (!consume(cursor, '"')) {
+            return false;
+        }
+        const char* start = cursor.pos;
+        while (cursor.pos != cursor.end && *cursor.pos != '"') {
+            if (*cursor.pos == '\\' && ++cursor.pos == cursor.end) {
+                return false;
+            }
+            ++cursor.pos;
+        }
+        if (cursor.pos == cursor.end) {
+            return false;
+        }
+        value = std::string_view(start, static_cast<std::size_t>(cursor.pos - start));
+        ++cursor.pos;
+        return true;
+    }
+
+    static bool skipValue(Cursor& cursor) {
+        skipWhitespace(cursor);
+        if (cursor.pos == cursor.end) {
+            return false;
+        }
+
+        std::string_view ignored;
+        switch (*cursor.pos) {
+        case '"':
+            return readString(cursor, ignored);
+        case '{':
+            return parseObject(cursor, [&](std::string_view) { return skipValue(cursor); });
+        case '[':
+            return parseArray(cursor, [&] { return skipValue(cursor); });
+        default: {
+            const char* start = cursor.pos;
+            while (cursor.pos != cursor.end && *cursor.pos != ',' && *cursor.pos != '}' &&
+                   *cursor.pos != ']' && *cursor.pos != ' ' && *cursor.pos != '\n' &&
+                   *cursor.pos != '\r' && *cursor.pos != '\t') {
+                ++cursor.pos;
+            }
+            return cursor.pos != start;
+        }
+        }
+    }
+
+    static bool readInteger(Cursor& cursor, std::int64_t& value) {
+        skipWhitespace(cursor);
+        auto [next, result] = std::from_chars(cursor.pos, cursor.end, value);
+        if (result != std::errc{} || (next != cursor.end && (*next == '.' || *next == 'e' || *next == 'E'))) {
+            cursor.error = "Orderbook level is not an integer pair";
+            return false;
+        }
+        cursor.pos = next;
+        return true;
+    }
+
+    // Reads a non-negative decimal, quoted or bare, as a whole number of
+    // 1/scale units, where scale is a power of ten. Digits finer than one unit
+    // are dropped if truncate is set and must be zero otherwise.
+    static bool readDecimal(Cursor& cursor, std::int64_t scale, bool truncate, std::int64_t& value) {
+        constexpr std::int64_t MaxWhole = 1'000'000'000'000;
+
+        bool quoted = consume(cursor, '"');
+        skipWhitespace(cursor);
+
+        std::int64_t whole = 0;
+        if (cursor.pos == cursor.end || *cursor.pos != '.') {
+            auto [next, result] = std::from_chars(cursor.pos, cursor.end, whole);
+            if (result != std::errc{} || *cursor.pos == '-' || whole >= MaxWhole) {
+                cursor.error = "Orderbook level is not a decimal pair";
+                return false;
+            }
+            cursor.pos = next;
+        }
+        value = whole * scale;
+
+        if (cursor.pos != cursor.end && *cursor.pos == '.') {
+            ++cursor.pos;
+            std::int64_t unit = scale;
+            for (; cursor.pos != cursor.end && *cursor.pos >= '0' && *cursor.pos <= '9'; ++cursor.pos) {
+                std::int64_t digit = *cursor.pos - '0';
+                unit /= 10;
+                if (unit > 0) {
+                    value += digit * unit;
+                } else if (digit != 0 && !truncate) {
+                    cursor.error = "Orderbook price is finer than the tick size";
+                    return false;
+                }
+            }
+        }
+
+        if (cursor.pos != cursor.end && (*cursor.pos == 'e' || *cursor.pos == 'E')) {
+            cursor.error = "Orderbook level is not a decimal pair";
+            return false;
+        }
+        return !quoted || consume(cursor, '"');
+    }
+
+    // Calls onMember(key) with the cursor on each member's value.
+    template <typename OnMember>
+    static bool parseObject(Cursor& cursor, OnMember&& onMember) {
+        if (!consume(cursor, '{')) {
+            return false;
+        }
+        if (consume(cursor, '}')) {
+            return true;
+        }
+        do {
+            std::string_view key;
+            if (!readString(cursor, key) || !consume(cursor, ':') || !onMember(key)) {
+                return false;
+            }
+        } while (consume(cursor, ','));
+        return consume(cursor, '}');
+    }
+
+    // Calls onElement() with the cursor on each element.
+    template <typename OnElement>
+    static bool parseArray(Cursor& cursor, OnElement&& onElement) {
+        if (!consume(cursor, '[')) {
+            return false;
+        }
+        if (consume(cursor, ']')) {
+            return true;
+        }
+        do {
+            if (!onElement()) {
+                return false;
+            }
+        } while (consume(cursor, ','));
+        return consume(cursor, ']');
+    }
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <Side.h>
+#include <Usings.h>
+
+#include "ExchangeAdapter.h"
+#include "OrderbookJsonParser.h"
+
+// Kalshi quotes resting YES and NO bids in cents. A NO bid at p is an offer to
+// sell YES at 100 - p, so NO levels become asks.
+struct KalshiDecoder {
+    static constexpr std::string_view DefaultEndpoint = "https://api.elections.kalshi.com/trade-api/v2/markets/";
+
+    void buildOrderbookUrl(std::string& url, const std::string& endpoint, const std::string& ticker) const {
+        url.assign(endpoint).append(ticker).append("/orderbook");
+    }
+
+    template <typename Handler>
+    bool decode(std::string_view body, Handler&& handler, const char*& error) const {
+        return OrderbookJsonParser::parse(body, [&](bool yes, Price price, Quantity quantity) {
+            if (yes) {
+                handler(Side::Buy, price, quantity);
+            } else {
+                handler(Side::Sell, 100 - price, quantity);
+            }
+        }, error);
+    }
+};
+
+using KalshiAdapter = BasicExchangeAdapter<KalshiDecoder>;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear histogram of latencies in any integer unit (nanoseconds, TSC
+// ticks): exact below 64, then 32 buckets per power of two, so any reported
+// percentile is within about 3% of the recorded value. Recording is a couple
+// of shifts and an increment.
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned SubBucketBits = 5;
+    static constexpr std::uint64_t SubBucketCount = std::uint64_t{ 1 } << SubBucketBits;
+    static constexpr std::size_t BucketCount = 64 * SubBucketCount;
+
+    static std::size_t Index(std::uint64_t value)
+    {
+        if (value < 2 * SubBucketCount)
+            return static_cast<std::size_t>(value);
+        unsigned shift = std::bit_width(value) - (SubBucketBits + 1);
+        return std::min<std::size_t>((shift + 1) * SubBucketCount + ((value >> shift) - SubBucketCount), BucketCount - 1);
+    }
+
+    static std::uint64_t LowerBound(std::size_t index)
+    {
+        if (index < 2 * SubBucketCount)
+            return index;
+        unsigned shift = static_cast<unsigned>(index / SubBucketCount) - 1;
+        return (SubBucketCount + index % SubBucketCount) << shift;
+    }
+
+private:
+    std::array<std::uint64_t, BucketCount> counts_{ };
+    std::uint64_t total_{ };
+    std::uint64_t max_{ };
+
+public:
+    void Record(std::uint64_t value)
+    {
+        ++counts_[Index(value)];
+        ++total_;
+        max_ = std::max(max_, value);
+    }
+
+    // Adds count samples to one bucket, for rebuilding a histogram from bucket
+    // counts kept elsewhere. The maximum becomes the bucket's lower bound.
+    void Add(std::size_t index, std::uint64_t count)
+    {
+        if (count == 0)
+            return;
+        counts_[index] += count;
+        total_ += count;
+        max_ = std::max(max_, LowerBound(index));
+    }
+
+    void Merge(const LatencyHistogram& other)
+    {
+        for (std::size_t index = 0; index < BucketCount; ++index)
+            counts_[index] += other.counts_[index];
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    std::uint64_t Count() const { return total_; }
+    std::uint64_t Max() const { return max_; }
+
+    // Lower bound of the bucket holding the given fraction of samples.
+    double Percentile(double percentile) const
+    {
+        if (total_ == 0)
+            return 0.0;
+
+        auto rank = static_cast<std::uint64_t>(percentile * static_cast<double>(total_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t index = 0; index < BucketCount; ++index)
+        {
+            seen += counts_[index];
+            if (seen >= rank)
+                return static_cast<double>(LowerBound(index));
+        }
+        return static_cast<double>(max_);
+    }
+};
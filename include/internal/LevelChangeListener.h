@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <LevelChange.h>
+
+#include "LevelOrderbook.h"
+
+// Receives a book's level changes, once per command that changed any level,
+// with each changed level listed once in the order it was first touched.
+// Called on the thread that owns the book; the span is only valid for the call.
+class LevelChangeListener
+{
+public:
+    virtual ~LevelChangeListener() = default;
+
+    virtual void OnLevelChanges(std::span<const LevelChange> changes) = 0;
+};
+
+// Forwards each batch of changes to every subscriber in subscription order.
+class LevelChangeFanout final : public LevelChangeListener
+{
+private:
+    std::vector<LevelChangeListener*> listeners_;
+
+public:
+    void Subscribe(LevelChangeListener* listener) { listeners_.push_back(listener); }
+
+    void Unsubscribe(LevelChangeListener* listener)
+    {
+        listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+    }
+
+    void OnLevelChanges(std::span<const LevelChange> changes) override
+    {
+        for (auto* listener : listeners_)
+            listener->OnLevelChanges(changes);
+    }
+};
+
+// Keeps a LevelOrderbook equal to the depth of the book it listens to.
+class LevelOrderbookMirror final : public LevelChangeListener
+{
+private:
+    LevelOrderbook& mirror_;
+
+public:
+    explicit LevelOrderbookMirror(LevelOrderbook& mirror)
+        : mirror_{ mirror }
+    { }
+
+    void OnLevelChanges(std::span<const LevelChange> changes) override
+    {
+        for (const auto& change : changes)
+            mirror_.SetLevel(change.side_, change.price_, change.quantity_);
+    }
+};
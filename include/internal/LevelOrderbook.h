@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+#include <Usings.h>
+#include <Side.h>
+#include <OrderbookLevelInfos.h>
+
+#include "PriceLevels.h"
+
+// Market-by-price book for mirroring an aggregated feed. Each level holds only
+// its total quantity and is overwritten in place, with no orders or matching.
+class LevelOrderbook
+{
+private:
+
+    struct Level
+    {
+        Quantity quantity_{ };
+    };
+
+    ArrayLevels<>::Ladder<Level, Side::Buy> bids_;
+    ArrayLevels<>::Ladder<Level, Side::Sell> asks_;
+
+public:
+
+    LevelOrderbook();
+    LevelOrderbook(const LevelOrderbook&) = delete;
+    void operator=(const LevelOrderbook&) = delete;
+    LevelOrderbook(LevelOrderbook&&) = delete;
+    void operator=(LevelOrderbook&&) = delete;
+    ~LevelOrderbook();
+
+    bool SetLevel(Side side, Price price, Quantity quantity);
+    void ClearLevel(Side side, Price price);
+    void Clear();
+
+    Quantity GetLevel(Side side, Price price) const;
+    std::size_t Size() const;
+    OrderbookLevelInfos GetOrderInfos() const;
+    OrderbookLevelInfos GetTopOfBook(std::size_t depth) const;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only private mapping of a whole file. Throws std::system_error if the
+// file cannot be opened or mapped. An empty file maps to a null, zero-size view.
+class MappedFile
+{
+private:
+    void* data_{ nullptr };
+    std::size_t size_{ };
+
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    void operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const std::byte* Data() const { return static_cast<const std::byte*>(data_); }
+    std::size_t Size() const { return size_; }
+};
+
+// Writes the whole buffer to fd, retrying short writes. Throws std::system_error.
+void WriteAll(int fd, const void* data, std::size_t size, const char* what);
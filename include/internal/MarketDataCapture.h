@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+// On-disk layout of a market-data capture: a header, then one variable-length
+// record per response, each a CaptureRecordHeader followed by the ticker and
+// the raw response body. Fields are written in host byte order.
+struct CaptureHeader {
+    static constexpr std::uint64_t Magic = 0x54504143424F524Dull; // "MORBCAPT"
+    static constexpr std::uint32_t CurrentVersion = 1;
+
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t recordHeaderSize;
+    std::uint64_t reserved[2];
+};
+
+static_assert(sizeof(CaptureHeader) == 32);
+
+struct CaptureRecordHeader {
+    // Wall-clock receive time in nanoseconds since the Unix epoch.
+    std::int64_t timestampNanoseconds;
+    std::int64_t responseCode;
+    std::uint32_t tickerSize;
+    std::uint32_t bodySize;
+};
+
+static_assert(sizeof(CaptureRecordHeader) == 24);
+
+// One recorded response. The views point into the mapped capture file.
+struct CapturedResponse {
+    std::int64_t timestampNanoseconds;
+    long responseCode;
+    std::string_view ticker;
+    std::string_view body;
+};
+
+// Truncates path and appends each response as it arrives with a single write.
+// Throws std::system_error if the file cannot be created or written.
+class MarketDataCaptureWriter {
+public:
+    explicit MarketDataCaptureWriter(const std::string& path);
+    ~MarketDataCaptureWriter();
+
+    MarketDataCaptureWriter(const MarketDataCaptureWriter&) = delete;
+    MarketDataCaptureWriter& operator=(const MarketDataCaptureWriter&) = delete;
+
+    void append(std::string_view ticker, long responseCode, std::string_view body);
+    void append(std::int64_t timestampNanoseconds, std::string_view ticker, long responseCode, std::string_view body);
+
+    std::uint64_t recordCount() const { return recordCount_; }
+
+private:
+    int fd_;
+    std::string buffer_;
+    std::uint64_t recordCount_;
+};
+
+// Maps a capture read-only and indexes its records in file order. A record cut
+// short by a crash at the end of the file is ignored. Throws std::system_error
+// if the file cannot be mapped and std::runtime_error if it is not a capture of
+// a supported version.
+class MarketDataCaptureReader {
+public:
+    explicit MarketDataCaptureReader(const std::string& path);
+
+    const std::vector<CapturedResponse>& responses() const { return responses_; }
+
+private:
+    MappedFile file_;
+    std::vector<CapturedResponse> responses_;
+};
@@ -1,12 +1,22 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 
 #include "Orderbook.h"
+#include "ExchangeAdapter.h"
+#include "LevelOrderbook.h"
+#include "MarketDataCapture.h"
 #include <LevelInfo.h>
 #include <OrderbookLevelInfos.h>
 #include <Order.h>
@@ -17,10 +27,57 @@ using json = nlohmann::json;
 struct APIResponse {
     std::string data;
     long responseCode;
+    std::string error;
     
     APIResponse() : responseCode(0) {}
 };
 
+// One reusable easy handle of the batch fetcher and the ticker it is serving.
+struct BatchTransfer {
+    CURL* curl;
+    APIResponse response;
+    std::string url;
+    std::size_t tickerIndex;
+
+    BatchTransfer() : curl(nullptr), tickerIndex(0) {}
+};
+
+// Recorded replays sleep until each response's offset from the first one in
+// the capture; Maximum serves every response immediately.
+enum class ReplaySpeed {
+    Recorded,
+    Maximum
+};
+
+// Captured responses of one ticker in file order and the next one to serve.
+struct ReplayCursor {
+    std::vector<const CapturedResponse*> responses;
+    std::size_t next;
+
+    ReplayCursor() : next(0) {}
+};
+
+using OrderbookResponseCallback = std::function<void(const std::string& ticker, const APIResponse& response)>;
+
+// Live state of one orderbook_delta subscription. The yes/no arrays mirror the
+// venue's resting quantity per cent so relative deltas can be applied, and each
+// non-empty level is set in place on a LevelOrderbook, or restored into an
+// Orderbook as one synthetic order with a fixed id, without matching.
+struct StreamSubscription {
+    Orderbook* orderbook;
+    LevelOrderbook* levelOrderbook;
+    std::uint64_t lastSeq;
+    bool synced;
+    // The id of the last subscribe command sent for this ticker, and the sid the
+    // venue answered it with (0 until the answer arrives).
+    int commandId;
+    std::uint64_t sid;
+    std::array<Quantity, KalshiMaxPrice + 1> yes;
+    std::array<Quantity, KalshiMaxPrice + 1> no;
+
+    StreamSubscription() : orderbook(nullptr), levelOrderbook(nullptr), lastSeq(0), synced(false), commandId(0), sid(0), yes{}, no{} {}
+};
+
 class MarketDataFeedHandler {
 public:
     MarketDataFeedHandler();
@@ -36,11 +93,49 @@ public:
     json fetchOrderbookData(const std::string& ticker);
     
     bool populateOrderbook(Orderbook& orderbook, const std::string& ticker);
+
+    bool populateOrderbook(LevelOrderbook& orderbook, const std::string& ticker);
     
     bool getOrderbookLevelInfos(const std::string& ticker, OrderbookLevelInfos& levelInfos);
 
+    std::size_t fetchOrderbooks(std::span<const std::string> tickers, const OrderbookResponseCallback& onResponse);
+
+    std::size_t populateOrderbooks(std::span<const std::string> tickers, std::span<LevelOrderbook* const> orderbooks);
+
+    bool connectStream();
+
+    void disconnectStream();
+
+    bool isStreamConnected() const;
+
+    bool subscribeOrderbook(const std::string& ticker, Orderbook& orderbook);
+    bool subscribeOrderbook(const std::string& ticker, LevelOrderbook& orderbook);
+
+    void attachOrderbook(const std::string& ticker, Orderbook& orderbook);
+    void attachOrderbook(const std::string& ticker, LevelOrderbook& orderbook);
+
+    bool pollStream(int timeoutMilliseconds);
+
+    bool handleStreamMessage(const std::string& message);
+
+    // The subscription attached for ticker, or nullptr if there is none.
+    const StreamSubscription* findStreamSubscription(const std::string& ticker) const;
+
+    bool startCapture(const std::string& path);
+    void stopCapture();
+    bool isCapturing() const;
+
+    bool startReplay(const std::string& path, ReplaySpeed speed = ReplaySpeed::Maximum);
+    void rewindReplay();
+    void stopReplay();
+    bool isReplaying() const;
+
+    void setExchangeAdapter(std::unique_ptr<ExchangeAdapter> adapter);
     void setApiEndpoint(const std::string& endpoint);
+    void setStreamEndpoint(const std::string& endpoint);
+    void addStreamHeader(const std::string& header);
     void setTimeout(long timeoutSeconds);
+    void setMaxConcurrentRequests(std::size_t maxConcurrentRequests);
     void setUserAgent(const std::string& userAgent);
     
     std::string getLastError() const;
@@ -51,13 +146,66 @@ private:
     
     bool performHttpRequest(const std::string& url, APIResponse& response);
     
-    std::string buildOrderbookUrl(const std::string& ticker) const;
-    
-    bool parseAndAddOrders(const json& orderbookData, Orderbook& orderbook, OrderId& currentOrderId);
-    
-    bool parseIntoLevelInfos(const json& orderbookData, LevelInfos& bids, LevelInfos& asks);
+    const std::string& buildOrderbookUrl(const std::string& ticker);
+
+    std::string_view fetchOrderbookBody(const std::string& ticker);
+
+    template <typename Handler>
+    bool parseOrderbookLevels(const std::string& ticker, Handler&& handler);
+
+    template <typename OrderbookType>
+    bool decodeOrderbookBody(std::string_view body, OrderbookType& orderbook);
+
+    template <typename Handler>
+    bool parseOrderbookBody(std::string_view body, Handler&& handler);
+
+    bool initializeBatch();
+
+    void cleanupBatch();
+
+    void startBatchTransfer(BatchTransfer& transfer, std::size_t tickerIndex, const std::string& ticker);
+
+    void captureResponse(const std::string& ticker, const APIResponse& response);
+
+    const CapturedResponse* nextReplayResponse(const std::string& ticker);
+
+    std::size_t replayOrderbooks(std::span<const std::string> tickers, const OrderbookResponseCallback& onResponse);
+
+    bool sendSubscribeCommand(const std::string& ticker);
+
+    bool sendStreamMessage(const std::string& message);
+
+    bool applyStreamSnapshot(StreamSubscription& subscription, const json& orderbookData);
+
+    void applyStreamLevels(StreamSubscription& subscription,
+                           const std::array<Quantity, KalshiMaxPrice + 1>& yes,
+                           const std::array<Quantity, KalshiMaxPrice + 1>& no);
+
+    bool applyStreamDelta(StreamSubscription& subscription, const json& delta);
+
+    bool requestStreamSnapshot(const std::string& ticker, StreamSubscription& subscription);
+
+    void setStreamLevel(StreamSubscription& subscription, bool yes, Price price, Quantity quantity);
 
     CURL* curl_;
+    APIResponse response_;
+    std::string url_;
+    CURLM* multi_;
+    std::vector<BatchTransfer> batchTransfers_;
+    std::size_t maxConcurrentRequests_;
+    std::unique_ptr<MarketDataCaptureWriter> capture_;
+    std::unique_ptr<MarketDataCaptureReader> replay_;
+    std::unordered_map<std::string_view, ReplayCursor> replayCursors_;
+    ReplaySpeed replaySpeed_;
+    std::chrono::steady_clock::time_point replayStart_;
+    CURL* streamCurl_;
+    curl_slist* streamHeaderList_;
+    std::string streamUrl_;
+    std::vector<std::string> streamHeaders_;
+    std::string streamBuffer_;
+    std::unordered_map<std::string, StreamSubscription> subscriptions_;
+    int nextCommandId_;
+    std::unique_ptr<ExchangeAdapter> adapter_;
     std::string baseUrl_;
     long timeout_;
     std::string userAgent_;
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <Usings.h>
+
+#include "QueuedOrder.h"
+
+// Open-addressing map from order id to resting order. Linear probing keeps each
+// lookup on a short run of adjacent slots, and deletes shift the following
+// run back instead of leaving tombstones, so erase is a single probe sequence.
+class OrderIndex
+{
+private:
+    struct Slot
+    {
+        OrderId orderId_{ };
+        QueuedOrder* order_{ nullptr };
+    };
+
+    static constexpr std::size_t MinCapacity = 16;
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_{ };
+    std::size_t shift_{ };
+    std::size_t size_{ };
+
+    std::size_t Home(OrderId orderId) const
+    {
+        return static_cast<std::size_t>((orderId * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    std::size_t Capacity() const { return slots_ ? mask_ + 1 : 0; }
+
+    void Rehash(std::size_t capacity)
+    {
+        auto oldCapacity = Capacity();
+        auto slots = std::move(slots_);
+
+        slots_ = std::make_unique<Slot[]>(capacity);
+        mask_ = capacity - 1;
+        shift_ = 64 - std::countr_zero(capacity);
+
+        for (std::size_t i = 0; i < oldCapacity; ++i)
+        {
+            if (!slots[i].order_)
+                continue;
+            auto index = Home(slots[i].orderId_);
+            while (slots_[index].order_)
+                index = (index + 1) & mask_;
+            slots_[index] = slots[i];
+        }
+    }
+
+public:
+    explicit OrderIndex(std::size_t capacityHint = 0)
+    {
+        Reserve(capacityHint);
+    }
+
+    std::size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+
+    void Reserve(std::size_t count)
+    {
+        auto capacity = std::bit_ceil(std::max(count * 2, MinCapacity));
+        if (capacity > Capacity())
+            Rehash(capacity);
+    }
+
+    QueuedOrder* Find(OrderId orderId) const
+    {
+        if (!slots_)
+            return nullptr;
+
+        for (auto index = Home(orderId); slots_[index].order_; index = (index + 1) & mask_)
+        {
+            if (slots_[index].orderId_ == orderId)
+                return slots_[index].order_;
+        }
+        return nullptr;
+    }
+
+    bool Contains(OrderId orderId) const { return Find(orderId) != nullptr; }
+
+    // Returns false and leaves the index unchanged if the id is already present.
+    bool Insert(OrderId orderId, QueuedOrder* order)
+    {
+        Reserve(size_ + 1);
+
+        auto index = Home(orderId);
+        for (; slots_[index].order_; index = (index + 1) & mask_)
+        {
+            if (slots_[index].orderId_ == orderId)
+                return false;
+        }
+
+        slots_[index] = Slot{ orderId, order };
+        ++size_;
+        return true;
+    }
+
+    // Removes the id and returns its order, or nullptr if it was not present.
+    QueuedOrder* Erase(OrderId orderId)
+    {
+        if (!slots_)
+            return nullptr;
+
+        auto index = Home(orderId);
+        while (slots_[index].orderId_ != orderId)
+        {
+            if (!slots_[index].order_)
+                return nullptr;
+            index = (index + 1) & mask_;
+        }
+        if (!slots_[index].order_)
+            return nullptr;
+
+        QueuedOrder* order = slots_[index].order_;
+        --size_;
+
+        auto hole = index;
+        for (auto next = (hole + 1) & mask_; slots_[next].order_; next = (next + 1) & mask_)
+        {
+            auto home = Home(slots_[next].orderId_);
+            bool staysPut = hole <= next
+                ? hole < home && home <= next
+                : hole < home || home <= next;
+            if (staysPut)
+                continue;
+
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+        slots_[hole] = Slot{ };
+
+        return order;
+    }
+};
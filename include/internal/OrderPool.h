@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "QueuedOrder.h"
+
+// Slab allocator for resting orders. Slots are carved out of fixed-size slabs
+// and recycled through an intrusive free list, so steady-state add/cancel
+// traffic never reaches the global allocator.
+class OrderPool
+{
+private:
+    static_assert(std::is_trivially_destructible_v<QueuedOrder>);
+
+    static constexpr std::size_t SlabSize = 1024;
+
+    union Slot
+    {
+        Slot* next_;
+        alignas(QueuedOrder) std::byte storage_[sizeof(QueuedOrder)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs_;
+    Slot* free_{ nullptr };
+    std::size_t used_{ SlabSize };
+
+public:
+    template <typename... Args>
+    QueuedOrder* Allocate(Args&&... args)
+    {
+        Slot* slot = free_;
+        if (slot)
+        {
+            free_ = slot->next_;
+        }
+        else
+        {
+            if (used_ == SlabSize)
+            {
+                slabs_.push_back(std::make_unique_for_overwrite<Slot[]>(SlabSize));
+                used_ = 0;
+            }
+            slot = &slabs_.back()[used_++];
+        }
+        return ::new (slot->storage_) QueuedOrder(std::forward<Args>(args)...);
+    }
+
+    void Release(QueuedOrder* order)
+    {
+        Slot* slot = reinterpret_cast<Slot*>(order);
+        slot->next_ = free_;
+        free_ = slot;
+    }
+};
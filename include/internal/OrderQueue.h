@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "QueuedOrder.h"
+
+// A run of consecutive queue positions.
+struct OrderQueueChunk
+{
+    static constexpr std::uint32_t Size = 32;
+
+    OrderQueueChunk* prev_;
+    OrderQueueChunk* next_;
+    // The first live slot, the slots handed out so far, and how many of them
+    // still hold an order.
+    std::uint32_t begin_;
+    std::uint32_t end_;
+    std::uint32_t live_;
+    // Null marks a cancelled slot.
+    std::array<QueuedOrder*, Size> orders_;
+};
+
+// Slab allocator for queue chunks, shared by every level of a book. Chunks are
+// recycled through a free list, so levels that come and go never reach the
+// global allocator once the book has warmed up.
+class OrderQueueChunkPool
+{
+private:
+    static constexpr std::size_t SlabSize = 64;
+
+    std::vector<std::unique_ptr<OrderQueueChunk[]>> slabs_;
+    OrderQueueChunk* free_{ nullptr };
+    std::size_t used_{ SlabSize };
+
+public:
+    OrderQueueChunk* Allocate()
+    {
+        OrderQueueChunk* chunk = free_;
+        if (chunk)
+        {
+            free_ = chunk->next_;
+        }
+        else
+        {
+            if (used_ == SlabSize)
+            {
+                slabs_.push_back(std::make_unique_for_overwrite<OrderQueueChunk[]>(SlabSize));
+                used_ = 0;
+            }
+            chunk = &slabs_.back()[used_++];
+        }
+        chunk->begin_ = 0;
+        chunk->end_ = 0;
+        chunk->live_ = 0;
+        return chunk;
+    }
+
+    void Release(OrderQueueChunk* chunk)
+    {
+        chunk->next_ = free_;
+        free_ = chunk;
+    }
+};
+
+// FIFO of resting orders at one price level, kept as a list of chunks of order
+// pointers. Walking the queue reads consecutive pointers rather than following
+// a link stored in each order, so the orders it visits can be fetched in
+// parallel however they are scattered through the pool. Cancelling leaves a
+// hole that the front and back skip past lazily; freed slots at the back are
+// reused, and a chunk goes back to the pool once its last order leaves. Each
+// QueuedOrder records its chunk and slot, so cancel is still O(1).
+class OrderQueue
+{
+private:
+    OrderQueueChunk* head_{ nullptr };
+    OrderQueueChunk* tail_{ nullptr };
+
+    static void SkipHoles(OrderQueueChunk* chunk)
+    {
+        while (!chunk->orders_[chunk->begin_])
+            ++chunk->begin_;
+    }
+
+    static void TrimBack(OrderQueueChunk* chunk)
+    {
+        while (!chunk->orders_[chunk->end_ - 1])
+            --chunk->end_;
+    }
+
+    // Off the fill path: runs once per chunk, not once per order.
+    [[gnu::noinline]] void Unlink(OrderQueueChunk* chunk, OrderQueueChunkPool& pool)
+    {
+        if (chunk->prev_)
+            chunk->prev_->next_ = chunk->next_;
+        else
+            head_ = chunk->next_;
+
+        if (chunk->next_)
+            chunk->next_->prev_ = chunk->prev_;
+        else
+            tail_ = chunk->prev_;
+
+        if (!chunk->next_ && tail_)
+            TrimBack(tail_);
+        pool.Release(chunk);
+    }
+
+    void Vacate(OrderQueueChunk* chunk, std::uint32_t slot, OrderQueueChunkPool& pool)
+    {
+        chunk->orders_[slot] = nullptr;
+        if (--chunk->live_ == 0)
+        {
+            Unlink(chunk, pool);
+            return;
+        }
+
+        if (slot == chunk->begin_)
+            SkipHoles(chunk);
+        if (chunk == tail_ && slot + 1 == chunk->end_)
+            TrimBack(chunk);
+    }
+
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const OrderQueueChunk* chunk, std::uint32_t slot) : chunk_{ chunk }, slot_{ slot } { }
+
+        Order& operator*() const { return *chunk_->orders_[slot_]; }
+        Order* operator->() const { return chunk_->orders_[slot_]; }
+        Iterator& operator++()
+        {
+            do
+            {
+                if (++slot_ == chunk_->end_)
+                {
+                    chunk_ = chunk_->next_;
+                    slot_ = chunk_ ? chunk_->begin_ : 0;
+                }
+            } while (chunk_ && !chunk_->orders_[slot_]);
+            return *this;
+        }
+        bool operator==(const Iterator&) const = default;
+
+    private:
+        const OrderQueueChunk* chunk_;
+        std::uint32_t slot_;
+    };
+
+    bool Empty() const { return head_ == nullptr; }
+    QueuedOrder* Front() const { return head_->orders_[head_->begin_]; }
+
+    void PushBack(QueuedOrder* order, OrderQueueChunkPool& pool)
+    {
+        if (!tail_ || tail_->end_ == OrderQueueChunk::Size)
+        {
+            OrderQueueChunk* chunk = pool.Allocate();
+            chunk->prev_ = tail_;
+            chunk->next_ = nullptr;
+            if (tail_)
+                tail_->next_ = chunk;
+            else
+                head_ = chunk;
+            tail_ = chunk;
+        }
+
+        auto slot = tail_->end_++;
+        tail_->orders_[slot] = order;
+        ++tail_->live_;
+        order->chunk_ = tail_;
+        order->slot_ = slot;
+    }
+
+    void PopFront(OrderQueueChunkPool& pool) { Vacate(head_, head_->begin_, pool); }
+
+    void Erase(QueuedOrder* order, OrderQueueChunkPool& pool) { Vacate(order->chunk_, order->slot_, pool); }
+
+    Iterator begin() const { return Iterator{ head_, head_ ? head_->begin_ : 0 }; }
+    Iterator end() const { return Iterator{ nullptr, 0 }; }
+};
@@ -1,24 +1,38 @@
 #pragma once
 
-#include <map>
-#include <unordered_map>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
 
 #include <Usings.h>
+#include <LevelChange.h>
 #include <Order.h>
 #include <OrderModify.h>
+#include <OrderbookCommand.h>
 #include <OrderbookLevelInfos.h>
+#include <SweepCost.h>
 #include <Trade.h>
 
-class Orderbook
+#include "DepthPublisher.h"
+#include "Probes.h"
+#include "LevelChangeListener.h"
+#include "OrderIndex.h"
+#include "OrderPool.h"
+#include "OrderQueue.h"
+#include "PriceLevels.h"
+
+// Receives each fill as it is produced. The Trade is only valid for the call.
+template <typename Sink>
+concept TradeSink = std::invocable<Sink&, const Trade&>;
+
+template <typename Levels>
+class BasicOrderbook
 {
 private:
 
-    struct OrderEntry
-    {
-        OrderPointer order_{ nullptr };
-        OrderPointers::iterator location_;
-    };
-
     struct LevelData
     {
         Quantity quantity_{ };
@@ -29,32 +43,361 @@ private:
             Add,
             Remove,
             Match,
+            Reduce,
         };
+
+        void Apply(Action action, Quantity quantity)
+        {
+            if (action == Action::Add)
+            {
+                quantity_ += quantity;
+                ++count_;
+                return;
+            }
+
+            quantity_ -= quantity;
+            if (action == Action::Remove)
+                --count_;
+        }
     };
 
-    std::unordered_map<Price, LevelData> data_;
-    std::map<Price, OrderPointers, std::greater<Price>> bids_;
-    std::map<Price, OrderPointers, std::less<Price>> asks_;
-    std::unordered_map<OrderId, OrderEntry> orders_;
+    struct Level
+    {
+        OrderQueue orders_;
+        LevelData data_;
+    };
+
+    OrderPool pool_;
+    OrderQueueChunkPool chunks_;
+    typename Levels::template Ladder<Level, Side::Buy> bids_;
+    typename Levels::template Ladder<Level, Side::Sell> asks_;
+    OrderIndex orders_;
+    DepthPublisher* depthPublisher_{ };
+    // The worst published price on each side, or the end of the range if the
+    // side had fewer levels than the publisher's depth. A change at or inside
+    // either bound marks the published depth dirty.
+    Price bidDepthBound_{ std::numeric_limits<Price>::max() };
+    Price askDepthBound_{ std::numeric_limits<Price>::min() };
+    bool depthDirty_{ };
+    LevelChangeListener* levelListener_{ };
+    // Levels touched by the current command, holding their state from before
+    // the first touch until EmitLevelChanges fills in the new one.
+    LevelChanges levelChanges_;
 
     void CancelOrder(OrderIds orderId);
+    bool RemoveOrder(OrderId orderId);
 
     bool CanMatch(Side side, Price price) const;
-    Trades MatchOrders();
+    bool CanFullyFill(Side side, Price price, Quantity quantity) const;
+    bool FindMarketPrice(Side side, Quantity quantity, Price& price) const;
+    template <TradeSink Sink>
+    void MatchOrders(Sink& onTrade);
+
+    bool AdmitOrder(OrderType orderType, Side side, Price& price, Quantity quantity) const;
+    void LinkOrder(QueuedOrder* order);
+    void UnlinkOrder(QueuedOrder* order);
+
+    bool InsertOrder(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity);
+    bool InsertRestoredOrder(OrderType orderType, OrderId orderId, Side side, Price price,
+        Quantity initialQuantity, Quantity remainingQuantity);
+    bool ModifyOrder(OrderId orderId, Side side, Price price, Quantity quantity);
+
+    void WriteDepth();
+    void RecordLevel(Side side, Price price);
+    void WriteLevelChanges();
+
+    // Called after a level's quantity is changed.
+    void SetLevelQuantity(Side side, Price price, const Level& level)
+    {
+        if (side == Side::Buy)
+            bids_.SetQuantity(price, level.data_.quantity_);
+        else
+            asks_.SetQuantity(price, level.data_.quantity_);
+    }
+
+    // Called before a level is changed.
+    void TouchLevel(Side side, Price price)
+    {
+        if (side == Side::Buy ? price >= bidDepthBound_ : price <= askDepthBound_)
+            depthDirty_ = true;
+        if (levelListener_)
+            RecordLevel(side, price);
+    }
+    void EmitLevelChanges()
+    {
+        if (!levelChanges_.empty())
+            WriteLevelChanges();
+    }
+    void PublishDepth()
+    {
+        if (depthDirty_)
+            WriteDepth();
+    }
+    void FinishCommand()
+    {
+        EmitLevelChanges();
+        PublishDepth();
+    }
 
 public:
 
-    Orderbook();
-    Orderbook(const Orderbook&) = delete;
-    void operator=(const Orderbook&) = delete;
-    Orderbook(Orderbook&&) = delete;
-    void operator=(Orderbook&&) = delete;
-    ~Orderbook();
+    BasicOrderbook();
+    explicit BasicOrderbook(std::size_t capacityHint);
+    BasicOrderbook(const BasicOrderbook&) = delete;
+    void operator=(const BasicOrderbook&) = delete;
+    BasicOrderbook(BasicOrderbook&&) = delete;
+    void operator=(BasicOrderbook&&) = delete;
+    ~BasicOrderbook();
 
+    // FillAndKill and Market orders cancel whatever does not fill at once, and
+    // a Market order ignores its price. FillOrKill is accepted only if the
+    // opposite levels up to its price hold its whole quantity, and PostOnly
+    // only if it would not cross. Rejected orders produce no trades.
+    Trades AddOrder(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity);
     Trades AddOrder(OrderPointer order);
     void CancelOrder(OrderId orderId);
+    // Amends a resting order. Lowering the quantity at the same side and price
+    // keeps its place in the queue; any other change moves it to the back of
+    // its new level, subject to the same checks as a new order of its type.
     Trades MatchOrder(OrderModify order);
+    Trades Apply(const OrderbookCommand& command);
+
+    // Same as the overloads above, but each fill is passed to onTrade instead
+    // of being collected into a Trades vector, so nothing is allocated.
+    template <TradeSink Sink>
+    void AddOrder(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity, Sink&& onTrade);
+    template <TradeSink Sink>
+    void MatchOrder(OrderModify order, Sink&& onTrade);
+
+    // Applies the commands in order with the same results as one call each, but
+    // appends every fill to the caller's trades buffer (cleared first), grows
+    // the order index once for the whole batch and publishes depth once at the
+    // end of it.
+    void ApplyBatch(std::span<const OrderbookCommand> commands, Trades& trades);
+    template <TradeSink Sink>
+    void ApplyBatch(std::span<const OrderbookCommand> commands, Sink&& onTrade);
 
     std::size_t Size() const;
     OrderbookLevelInfos GetOrderInfos() const;
+    OrderbookLevelInfos GetTopOfBook(std::size_t depth) const;
+
+    // Depth queries from the point of view of an order on side, so they read
+    // the opposite levels. LadderOrderbook answers them from a dense array of
+    // per-tick quantities with DepthKernels; Orderbook walks its levels.
+
+    // How much an order on side limited to price could fill right now, the
+    // check behind FillOrKill.
+    std::uint64_t GetFillableQuantity(Side side, Price price) const;
+    // What taking quantity at any price would cost, best level first. The
+    // average price is the volume-weighted price for that size.
+    SweepCost GetSweepCost(Side side, std::uint64_t quantity) const;
+    // GetFillableQuantity for each tick from first: depth[i] is what an order
+    // limited to first + i could fill.
+    void GetCumulativeDepth(Side side, Price first, std::span<std::uint64_t> depth) const;
+
+    // Grows the order index so count resting orders fit without rehashing.
+    void Reserve(std::size_t count);
+
+    // After every call that changes the top publisher->Depth() levels of either
+    // side, copies them into publisher for reader threads. Pass nullptr to stop.
+    // The publisher must outlive the book or be detached first.
+    void SetDepthPublisher(DepthPublisher* publisher);
+
+    // Reports the new quantity and order count of every level a command changed,
+    // coalesced per command: per call, or per command within ApplyBatch. Levels
+    // that end a command as they started are left out. Seed the listener from
+    // GetOrderInfos() when attaching to a non-empty book; pass nullptr to stop.
+    void SetLevelChangeListener(LevelChangeListener* listener);
+
+    // Visits every resting order, bids then asks, best level first and in
+    // queue order within each level.
+    template <typename Function>
+    void ForEachOrder(Function&& function) const;
+
+    // Appends a resting order to the back of its level without matching, for
+    // rebuilding a book in queue order. The caller must not restore a crossed
+    // book. Returns false for a duplicate id, an out-of-range price or an
+    // invalid quantity.
+    bool RestoreOrder(OrderType orderType, OrderId orderId, Side side, Price price,
+        Quantity initialQuantity, Quantity remainingQuantity);
+
+    // Restores orders in the order given, as RestoreOrder does, but as a single
+    // command: level changes are reported and depth published once, after the
+    // last. All or nothing: if any order would be rejected, the ones restored
+    // before it are removed again and false is returned with the book as it was.
+    bool RestoreOrders(std::span<const Order> orders);
 };
+
+using Orderbook = BasicOrderbook<MapLevels>;
+using LadderOrderbook = BasicOrderbook<ArrayLevels<>>;
+
+template <typename Levels>
+template <TradeSink Sink>
+void BasicOrderbook<Levels>::MatchOrders(Sink& onTrade)
+{
+    MORNINGSIDE_PROBE(MatchOrders);
+
+    while (!bids_.Empty() && !asks_.Empty())
+    {
+        Price bidPrice = bids_.BestPrice();
+        Price askPrice = asks_.BestPrice();
+
+        if (bidPrice < askPrice)
+            break;
+
+        TouchLevel(Side::Buy, bidPrice);
+        TouchLevel(Side::Sell, askPrice);
+
+        auto& bids = bids_.Best();
+        auto& asks = asks_.Best();
+
+        while (!bids.orders_.Empty() && !asks.orders_.Empty())
+        {
+            QueuedOrder* bid = bids.orders_.Front();
+            QueuedOrder* ask = asks.orders_.Front();
+            Quantity quantity = std::min(bid->GetRemainingQuantity(), ask->GetRemainingQuantity());
+            bid->Fill(quantity);
+            ask->Fill(quantity);
+
+            onTrade(Trade{
+                TradeInfo{ bid->GetOrderId(), bid->GetPrice(), quantity },
+                TradeInfo{ ask->GetOrderId(), ask->GetPrice(), quantity }
+            });
+            MORNINGSIDE_COUNT(Trades, 1);
+
+            if (bid->IsFilled())
+            {
+                bids.data_.Apply(LevelData::Action::Remove, quantity);
+                bids.orders_.PopFront(chunks_);
+                orders_.Erase(bid->GetOrderId());
+                pool_.Release(bid);
+            }
+            else
+            {
+                bids.data_.Apply(LevelData::Action::Match, quantity);
+            }
+
+            if (ask->IsFilled())
+            {
+                asks.data_.Apply(LevelData::Action::Remove, quantity);
+                asks.orders_.PopFront(chunks_);
+                orders_.Erase(ask->GetOrderId());
+                pool_.Release(ask);
+            }
+            else
+            {
+                asks.data_.Apply(LevelData::Action::Match, quantity);
+            }
+        }
+
+        bids_.SetQuantity(bidPrice, bids.data_.quantity_);
+        asks_.SetQuantity(askPrice, asks.data_.quantity_);
+
+        if (bids.orders_.Empty())
+        {
+            bids_.Erase(bidPrice);
+            MORNINGSIDE_COUNT(LevelsErased, 1);
+        }
+        if (asks.orders_.Empty())
+        {
+            asks_.Erase(askPrice);
+            MORNINGSIDE_COUNT(LevelsErased, 1);
+        }
+    }
+
+    if (!bids_.Empty())
+    {
+        Order* order = bids_.Best().orders_.Front();
+        if (order->GetOrderType() == OrderType::FillAndKill || order->GetOrderType() == OrderType::Market)
+        {
+            MORNINGSIDE_COUNT(FillAndKillCancels, 1);
+            RemoveOrder(order->GetOrderId());
+        }
+    }
+
+    if (!asks_.Empty())
+    {
+        Order* order = asks_.Best().orders_.Front();
+        if (order->GetOrderType() == OrderType::FillAndKill || order->GetOrderType() == OrderType::Market)
+        {
+            MORNINGSIDE_COUNT(FillAndKillCancels, 1);
+            RemoveOrder(order->GetOrderId());
+        }
+    }
+}
+
+template <typename Levels>
+template <TradeSink Sink>
+void BasicOrderbook<Levels>::AddOrder(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity, Sink&& onTrade)
+{
+    MORNINGSIDE_PROBE(AddOrder);
+    if (InsertOrder(orderType, orderId, side, price, quantity))
+    {
+        MatchOrders(onTrade);
+        FinishCommand();
+    }
+}
+
+template <typename Levels>
+template <TradeSink Sink>
+void BasicOrderbook<Levels>::MatchOrder(OrderModify order, Sink&& onTrade)
+{
+    MORNINGSIDE_PROBE(ModifyOrder);
+    if (ModifyOrder(order.GetOrderId(), order.GetSide(), order.GetPrice(), order.GetQuantity()))
+        MatchOrders(onTrade);
+    FinishCommand();
+}
+
+template <typename Levels>
+template <TradeSink Sink>
+void BasicOrderbook<Levels>::ApplyBatch(std::span<const OrderbookCommand> commands, Sink&& onTrade)
+{
+    auto adds = std::count_if(commands.begin(), commands.end(), [](const OrderbookCommand& command)
+        {
+            return command.action_ == OrderbookCommand::Action::Add;
+        });
+    orders_.Reserve(orders_.Size() + static_cast<std::size_t>(adds));
+
+    for (const auto& command : commands)
+    {
+        switch (command.action_)
+        {
+        case OrderbookCommand::Action::Add:
+        {
+            MORNINGSIDE_PROBE(AddOrder);
+            if (InsertOrder(command.orderType_, command.orderId_, command.side_, command.price_, command.quantity_))
+                MatchOrders(onTrade);
+            break;
+        }
+        case OrderbookCommand::Action::Cancel:
+        {
+            MORNINGSIDE_PROBE(CancelOrder);
+            RemoveOrder(command.orderId_);
+            break;
+        }
+        case OrderbookCommand::Action::Modify:
+        {
+            MORNINGSIDE_PROBE(ModifyOrder);
+            if (ModifyOrder(command.orderId_, command.side_, command.price_, command.quantity_))
+                MatchOrders(onTrade);
+            break;
+        }
+        }
+        EmitLevelChanges();
+    }
+
+    PublishDepth();
+}
+
+template <typename Levels>
+template <typename Function>
+void BasicOrderbook<Levels>::ForEachOrder(Function&& function) const
+{
+    auto visitLevel = [&function](Price, const Level& level)
+    {
+        for (const Order& order : level.orders_)
+            function(order);
+    };
+    bids_.ForEach(visitLevel);
+    asks_.ForEach(visitLevel);
+}
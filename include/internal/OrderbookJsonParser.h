@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include <Usings.h>
+
+#include "JsonScanner.h"
+
+// Single-pass scanner for the REST orderbook response. It walks the body in
+// place and hands each [price, quantity] pair under "orderbook"."yes"/"no" to a
+// handler, skipping every other field without building a DOM or allocating.
+class OrderbookJsonParser : JsonScanner {
+public:
+    // Calls handler(bool yes, Price price, Quantity quantity) for each level in
+    // document order. On failure returns false and points error at a static message.
+    template <typename Handler>
+    static bool parse(std::string_view body, Handler&& handler, const char*& error) {
+        Cursor cursor{body.data(), body.data() + body.size(), nullptr};
+        bool foundOrderbook = false;
+
+        if (!parseObject(cursor, [&](std::string_view key) {
+                if (key != "orderbook") {
+                    return skipValue(cursor);
+                }
+                foundOrderbook = true;
+                return parseOrderbook(cursor, handler);
+            })) {
+            error = cursor.error ? cursor.error : "Malformed orderbook JSON";
+            return false;
+        }
+
+        if (!foundOrderbook) {
+            error = "Invalid response: missing orderbook data";
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    template <typename Handler>
+    static bool parseLevels(Cursor& cursor, bool yes, Handler& handler) {
+        if (!peek(cursor, '[')) {
+            return skipValue(cursor);
+        }
+
+        return parseArray(cursor, [&] {
+            std::int64_t price = 0;
+            std::int64_t quantity = 0;
+            if (!consume(cursor, '[') || !readInteger(cursor, price) ||
+                !consume(cursor, ',') || !readInteger(cursor, quantity)) {
+                return false;
+            }
+            while (consume(cursor, ',')) {
+                if (!skipValue(cursor)) {
+                    return false;
+                }
+            }
+            if (!consume(cursor, ']')) {
+                return false;
+            }
+            if (price < std::numeric_limits<Price>::min() || price > std::numeric_limits<Price>::max() ||
+                quantity < 0 || quantity > std::numeric_limits<Quantity>::max()) {
+                cursor.error = "Orderbook level out of range";
+                return false;
+            }
+            handler(yes, static_cast<Price>(price), static_cast<Quantity>(quantity));
+            return true;
+        });
+    }
+
+    template <typename Handler>
+    static bool parseOrderbook(Cursor& cursor, Handler& handler) {
+        if (!peek(cursor, '{')) {
+            return false;
+        }
+        return parseObject(cursor, [&](std::string_view key) {
+            if (key == "yes") {
+                return parseLevels(cursor, true, handler);
+            }
+            if (key == "no") {
+                return parseLevels(cursor, false, handler);
+            }
+            return skipValue(cursor);
+        });
+    }
+};
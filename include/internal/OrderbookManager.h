@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <OrderbookCommand.h>
+
+#include "Orderbook.h"
+
+using MarketId = std::uint32_t;
+
+struct MarketCommand
+{
+    MarketId marketId_;
+    OrderbookCommand command_;
+};
+
+// Owns one book per market and partitions the markets across worker threads.
+// Each shard drains its own command queue and is the only thread that touches
+// its books, so book operations run without locks. A submitted batch takes
+// the queue lock once for each shard it has commands for, not per operation.
+template <typename Levels>
+class BasicOrderbookManager
+{
+public:
+    using OrderbookType = BasicOrderbook<Levels>;
+
+private:
+
+    struct alignas(64) Shard
+    {
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::condition_variable drained_;
+        std::vector<MarketCommand> pending_;
+        std::uint64_t submitted_{ };
+        std::uint64_t processed_{ };
+        bool stopping_{ };
+
+        std::vector<MarketCommand> batch_;
+        // One run of consecutive commands for the same market, as its book
+        // takes them.
+        std::vector<OrderbookCommand> run_;
+        std::atomic<std::uint64_t> tradeCount_{ };
+        std::thread thread_;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<std::unique_ptr<OrderbookType>> orderbooks_;
+    std::unordered_map<std::string, MarketId> marketIds_;
+    bool pinThreads_;
+    bool running_{ };
+
+    void Run(std::size_t shardIndex);
+    void Apply(Shard& shard, MarketId marketId, std::span<const MarketCommand> commands);
+    void Enqueue(Shard& shard, std::span<const MarketCommand> commands);
+
+public:
+
+    explicit BasicOrderbookManager(std::size_t shardCount, bool pinThreads = true);
+    BasicOrderbookManager(const BasicOrderbookManager&) = delete;
+    void operator=(const BasicOrderbookManager&) = delete;
+    BasicOrderbookManager(BasicOrderbookManager&&) = delete;
+    void operator=(BasicOrderbookManager&&) = delete;
+    ~BasicOrderbookManager();
+
+    // Markets can only be added while the workers are stopped.
+    MarketId AddMarket(const std::string& ticker, std::size_t capacityHint = 0);
+    MarketId GetMarketId(const std::string& ticker) const;
+
+    void Start();
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    void Submit(const MarketCommand& command);
+    void Submit(std::span<const MarketCommand> commands);
+
+    // Blocks until every command submitted so far has been applied.
+    void Drain();
+
+    // Only safe to call while stopped, or after Drain() with no concurrent Submit().
+    OrderbookType& GetOrderbook(MarketId marketId) { return *orderbooks_[marketId]; }
+    const OrderbookType& GetOrderbook(MarketId marketId) const { return *orderbooks_[marketId]; }
+
+    std::size_t ShardCount() const { return shards_.size(); }
+    std::size_t MarketCount() const { return orderbooks_.size(); }
+    std::size_t ShardOf(MarketId marketId) const { return marketId % shards_.size(); }
+    std::uint64_t TradeCount() const;
+};
+
+using OrderbookManager = BasicOrderbookManager<MapLevels>;
+using LadderOrderbookManager = BasicOrderbookManager<ArrayLevels<>>;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include <OrderbookCommand.h>
+#include <Trade.h>
+
+#include "Orderbook.h"
+#include "SpscRing.h"
+
+// Runs one book on its own thread. A feed thread enqueues commands into a
+// lock-free ring and a result thread (often the same feed thread) dequeues the
+// trades they produce from a second ring, so decoding and matching overlap.
+// Each ring has exactly one producer and one consumer.
+template <typename Levels>
+class BasicOrderbookWorker
+{
+public:
+    using OrderbookType = BasicOrderbook<Levels>;
+
+private:
+    static constexpr std::size_t BatchSize = 64;
+
+    OrderbookType orderbook_;
+    SpscRing<OrderbookCommand> commands_;
+    SpscRing<Trade> trades_;
+    std::atomic<bool> stopping_{ };
+    std::atomic<std::uint64_t> droppedTrades_{ };
+    std::thread thread_;
+
+    void Run(int cpu);
+    void Publish(const Trade& trade);
+
+public:
+
+    explicit BasicOrderbookWorker(std::size_t ringCapacity = 1 << 16, std::size_t capacityHint = 0);
+    BasicOrderbookWorker(const BasicOrderbookWorker&) = delete;
+    void operator=(const BasicOrderbookWorker&) = delete;
+    BasicOrderbookWorker(BasicOrderbookWorker&&) = delete;
+    void operator=(BasicOrderbookWorker&&) = delete;
+    ~BasicOrderbookWorker();
+
+    // Pins the worker to cpu when it is not negative.
+    void Start(int cpu = -1);
+    // Applies every command already enqueued, then joins the worker.
+    void Stop();
+    bool IsRunning() const { return thread_.joinable(); }
+
+    // Producer side. TrySubmit returns false when the ring is full; Submit waits
+    // for space, so a thread that also polls trades should use TrySubmit and
+    // drain trades whenever it fails.
+    bool TrySubmit(const OrderbookCommand& command) { return commands_.TryPush(command); }
+    void Submit(const OrderbookCommand& command);
+
+    // Result side. Trades must be drained while the worker runs, or it stalls
+    // once the trade ring fills.
+    bool TryPollTrade(Trade& trade) { return trades_.TryPop(trade); }
+
+    template <typename Function>
+    std::size_t PollTrades(Function&& onTrade, std::size_t limit = static_cast<std::size_t>(-1))
+    {
+        std::size_t count = 0;
+        Trade trade;
+        while (count < limit && trades_.TryPop(trade))
+        {
+            onTrade(trade);
+            ++count;
+        }
+        return count;
+    }
+
+    // Trades discarded because the ring was still full when Stop() was called.
+    std::uint64_t DroppedTrades() const { return droppedTrades_.load(std::memory_order_relaxed); }
+
+    // Only safe to call while the worker is stopped.
+    OrderbookType& GetOrderbook() { return orderbook_; }
+    const OrderbookType& GetOrderbook() const { return orderbook_; }
+};
+
+using OrderbookWorker = BasicOrderbookWorker<MapLevels>;
+using LadderOrderbookWorker = BasicOrderbookWorker<ArrayLevels<>>;
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include <Side.h>
+#include <Usings.h>
+
+constexpr Price KalshiMinPrice = 1;
+constexpr Price KalshiMaxPrice = 99;
+
+// One side of the book backed by a red-black tree, best level first.
+template <typename Level, Side side>
+class MapPriceLevels
+{
+private:
+    using Compare = std::conditional_t<side == Side::Buy, std::greater<Price>, std::less<Price>>;
+
+    std::map<Price, Level, Compare> levels_;
+
+public:
+    static constexpr bool InRange(Price) { return true; }
+
+    // Only the array ladder keeps a dense copy of its quantities.
+    void SetQuantity(Price, Quantity) { }
+
+    bool Empty() const { return levels_.empty(); }
+    std::size_t Size() const { return levels_.size(); }
+
+    Price BestPrice() const { return levels_.begin()->first; }
+    Level& Best() { return levels_.begin()->second; }
+    const Level& Best() const { return levels_.begin()->second; }
+
+    Level& operator[](Price price) { return levels_[price]; }
+    Level& At(Price price) { return levels_.at(price); }
+    void Erase(Price price) { levels_.erase(price); }
+    void Clear() { levels_.clear(); }
+
+    const Level* Find(Price price) const
+    {
+        auto iterator = levels_.find(price);
+        return iterator == levels_.end() ? nullptr : &iterator->second;
+    }
+
+    template <typename Function>
+    void ForEach(Function&& function, std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+    {
+        for (auto iterator = levels_.begin(); limit > 0 && iterator != levels_.end(); ++iterator, --limit)
+            function(iterator->first, iterator->second);
+    }
+
+    // Visits levels best first until function returns false.
+    template <typename Function>
+    void ForEachWhile(Function&& function) const
+    {
+        for (auto iterator = levels_.begin(); iterator != levels_.end(); ++iterator)
+        {
+            if (!function(iterator->first, iterator->second))
+                return;
+        }
+    }
+};
+
+// One side of the book stored as a flat array indexed by tick. An occupancy
+// bitmap finds the next non-empty level and the best level is kept as a cursor.
+// Alongside the levels sits a dense array of their quantities, kept up to date
+// by the owner through SetQuantity, for sweeps that would otherwise stride
+// through whole levels.
+template <typename Level, Side side, Price MinPrice, Price MaxPrice>
+class ArrayPriceLevels
+{
+private:
+    static_assert(MinPrice <= MaxPrice);
+
+    static constexpr std::size_t LevelCount = MaxPrice - MinPrice + 1;
+    static constexpr std::size_t WordCount = (LevelCount + 63) / 64;
+    static constexpr std::size_t NoLevel = LevelCount;
+
+    std::array<Level, LevelCount> levels_{ };
+    std::array<Quantity, LevelCount> quantities_{ };
+    std::array<std::uint64_t, WordCount> occupied_{ };
+    std::size_t size_{ };
+    std::size_t best_{ NoLevel };
+
+    static std::size_t Index(Price price) { return static_cast<std::size_t>(price - MinPrice); }
+
+    bool IsOccupied(std::size_t index) const { return (occupied_[index / 64] >> (index % 64)) & 1; }
+
+    static bool IsBetter(std::size_t lhs, std::size_t rhs)
+    {
+        return side == Side::Buy ? lhs > rhs : lhs < rhs;
+    }
+
+    std::size_t FindAtOrAbove(std::size_t index) const
+    {
+        for (std::size_t word = index / 64; word < WordCount; ++word)
+        {
+            std::uint64_t bits = occupied_[word];
+            if (word == index / 64)
+                bits &= ~std::uint64_t{ 0 } << (index % 64);
+            if (bits)
+                return word * 64 + std::countr_zero(bits);
+        }
+        return NoLevel;
+    }
+
+    std::size_t FindAtOrBelow(std::size_t index) const
+    {
+        for (std::size_t word = index / 64 + 1; word-- > 0; )
+        {
+            std::uint64_t bits = occupied_[word];
+            if (word == index / 64)
+                bits &= ~std::uint64_t{ 0 } >> (63 - index % 64);
+            if (bits)
+                return word * 64 + 63 - std::countl_zero(bits);
+        }
+        return NoLevel;
+    }
+
+    std::size_t Next(std::size_t index) const
+    {
+        if constexpr (side == Side::Buy)
+            return index == 0 ? NoLevel : FindAtOrBelow(index - 1);
+        else
+            return index + 1 == LevelCount ? NoLevel : FindAtOrAbove(index + 1);
+    }
+
+public:
+    static constexpr Price FirstPrice = MinPrice;
+
+    static constexpr bool InRange(Price price) { return price >= MinPrice && price <= MaxPrice; }
+
+    // One entry per tick from FirstPrice; empty levels read zero.
+    std::span<const Quantity, LevelCount> Quantities() const { return quantities_; }
+    void SetQuantity(Price price, Quantity quantity) { quantities_[Index(price)] = quantity; }
+
+    bool Empty() const { return size_ == 0; }
+    std::size_t Size() const { return size_; }
+
+    Price BestPrice() const { return MinPrice + static_cast<Price>(best_); }
+    Level& Best() { return levels_[best_]; }
+    const Level& Best() const { return levels_[best_]; }
+
+    Level& operator[](Price price)
+    {
+        auto index = Index(price);
+        if (!IsOccupied(index))
+        {
+            occupied_[index / 64] |= std::uint64_t{ 1 } << (index % 64);
+            if (size_++ == 0 || IsBetter(index, best_))
+                best_ = index;
+        }
+        return levels_[index];
+    }
+
+    Level& At(Price price)
+    {
+        if (!InRange(price) || !IsOccupied(Index(price)))
+            throw std::out_of_range("Price level does not exist.");
+        return levels_[Index(price)];
+    }
+
+    const Level* Find(Price price) const
+    {
+        if (!InRange(price) || !IsOccupied(Index(price)))
+            return nullptr;
+        return &levels_[Index(price)];
+    }
+
+    void Clear()
+    {
+        for (auto index = best_; index != NoLevel; index = Next(index))
+            levels_[index] = Level{ };
+        quantities_ = { };
+        occupied_ = { };
+        size_ = 0;
+        best_ = NoLevel;
+    }
+
+    void Erase(Price price)
+    {
+        auto index = Index(price);
+        if (!InRange(price) || !IsOccupied(index))
+            return;
+
+        occupied_[index / 64] &= ~(std::uint64_t{ 1 } << (index % 64));
+        levels_[index] = Level{ };
+        quantities_[index] = 0;
+        if (--size_ == 0)
+            best_ = NoLevel;
+        else if (index == best_)
+            best_ = Next(index);
+    }
+
+    template <typename Function>
+    void ForEach(Function&& function, std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+    {
+        for (auto index = best_; limit > 0 && index != NoLevel; index = Next(index), --limit)
+            function(MinPrice + static_cast<Price>(index), levels_[index]);
+    }
+
+    // Visits levels best first until function returns false.
+    template <typename Function>
+    void ForEachWhile(Function&& function) const
+    {
+        for (auto index = best_; index != NoLevel; index = Next(index))
+        {
+            if (!function(MinPrice + static_cast<Price>(index), levels_[index]))
+                return;
+        }
+    }
+};
+
+struct MapLevels
+{
+    template <typename Level, Side side>
+    using Ladder = MapPriceLevels<Level, side>;
+};
+
+template <Price MinPrice = KalshiMinPrice, Price MaxPrice = KalshiMaxPrice>
+struct ArrayLevels
+{
+    template <typename Level, Side side>
+    using Ladder = ArrayPriceLevels<Level, side, MinPrice, MaxPrice>;
+};
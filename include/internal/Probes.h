@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "LatencyHistogram.h"
+
+// Hot-path instrumentation. Built with MORNINGSIDE_INSTRUMENTATION defined, the
+// MORNINGSIDE_PROBE and MORNINGSIDE_COUNT macros time scopes with the TSC and
+// bump event counters in per-thread storage; otherwise they expand to nothing.
+// This is all the hot path needs; reading the metrics back is declared in
+// Instrumentation.h.
+
+enum class LatencyProbe : std::uint8_t
+{
+    AddOrder,
+    CancelOrder,
+    ModifyOrder,
+    MatchOrders,
+    FeedFetch,
+    FeedDecode,
+    FeedPopulate,
+    Count,
+};
+
+enum class EventCounter : std::uint8_t
+{
+    OrdersAdded,
+    OrdersRejected,
+    OrdersCancelled,
+    OrdersModified,
+    LevelsCreated,
+    LevelsErased,
+    Trades,
+    FillAndKillCancels,
+    Count,
+};
+
+inline constexpr std::size_t LatencyProbeCount = static_cast<std::size_t>(LatencyProbe::Count);
+inline constexpr std::size_t EventCounterCount = static_cast<std::size_t>(EventCounter::Count);
+
+// The TSC where available, steady_clock nanoseconds elsewhere.
+inline std::uint64_t ReadTicks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// One thread's histograms and counters. Only the owning thread writes, so an
+// update is a relaxed load and store with no locked instruction, and readers
+// on other threads see each value whole.
+class ThreadMetrics
+{
+private:
+    using Buckets = std::array<std::atomic<std::uint64_t>, LatencyHistogram::BucketCount>;
+
+    std::array<Buckets, LatencyProbeCount> probes_{ };
+    std::array<std::atomic<std::uint64_t>, EventCounterCount> counters_{ };
+
+    static void Increment(std::atomic<std::uint64_t>& value, std::uint64_t amount)
+    {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+public:
+    void Record(LatencyProbe probe, std::uint64_t ticks)
+    {
+        Increment(probes_[static_cast<std::size_t>(probe)][LatencyHistogram::Index(ticks)], 1);
+    }
+
+    void Add(EventCounter counter, std::uint64_t amount)
+    {
+        Increment(counters_[static_cast<std::size_t>(counter)], amount);
+    }
+
+    friend class MetricsSnapshot;
+};
+
+// The calling thread's metrics, registered on first use. They outlive the
+// thread, so a snapshot still includes threads that have exited.
+ThreadMetrics& LocalMetrics();
+
+class ScopedProbe
+{
+private:
+    LatencyProbe probe_;
+    std::uint64_t start_;
+
+public:
+    explicit ScopedProbe(LatencyProbe probe)
+        : probe_{ probe }
+        , start_{ ReadTicks() }
+    { }
+
+    ScopedProbe(const ScopedProbe&) = delete;
+    void operator=(const ScopedProbe&) = delete;
+
+    ~ScopedProbe() { LocalMetrics().Record(probe_, ReadTicks() - start_); }
+};
+
+#define MORNINGSIDE_CONCAT_IMPL(a, b) a##b
+#define MORNINGSIDE_CONCAT(a, b) MORNINGSIDE_CONCAT_IMPL(a, b)
+
+#if defined(MORNINGSIDE_INSTRUMENTATION)
+#define MORNINGSIDE_PROBE(probe) ::ScopedProbe MORNINGSIDE_CONCAT(morningsideProbe, __LINE__){ ::LatencyProbe::probe }
+#define MORNINGSIDE_COUNT(counter, amount) ::LocalMetrics().Add(::EventCounter::counter, (amount))
+#else
+#define MORNINGSIDE_PROBE(probe) static_cast<void>(0)
+#define MORNINGSIDE_COUNT(counter, amount) static_cast<void>(0)
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include <Order.h>
+
+struct OrderQueueChunk;
+
+// An order resting in a book, together with its place in its level's queue so
+// it can be unlinked in O(1). Only the book's internals deal in this type;
+// everything outside sees a plain Order.
+class QueuedOrder : public Order
+{
+public:
+    using Order::Order;
+
+private:
+    friend class OrderQueue;
+
+    OrderQueueChunk* chunk_{ nullptr };
+    std::uint32_t slot_{ };
+};
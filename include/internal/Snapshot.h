@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include <Usings.h>
+
+#include "MappedFile.h"
+#include "Orderbook.h"
+
+// Versioned, position-independent image of a book's resting orders. Orders
+// follow the header as fixed-width records, bids then asks, best level first
+// and in queue order within a level, so loading is a single sequential pass.
+// Fields are written in host byte order.
+struct SnapshotHeader
+{
+    static constexpr std::uint64_t Magic = 0x50414E53424F524Dull; // "MORBSNAP"
+    static constexpr std::uint32_t CurrentVersion = 1;
+
+    std::uint64_t magic_;
+    std::uint32_t version_;
+    std::uint32_t orderSize_;
+    std::uint64_t orderCount_;
+    // Number of journal records already reflected in the snapshot, so replay
+    // can resume from the journal tail.
+    std::uint64_t journalPosition_;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32);
+
+struct SnapshotOrder
+{
+    OrderId orderId_;
+    Price price_;
+    Quantity initialQuantity_;
+    Quantity remainingQuantity_;
+    std::uint8_t orderType_;
+    std::uint8_t side_;
+    std::uint16_t reserved_;
+};
+
+static_assert(sizeof(SnapshotOrder) == 24);
+
+// Writes the book to path atomically: the snapshot goes to a temporary file
+// that is fsynced and then renamed over path. Throws std::system_error.
+template <typename Levels>
+void WriteSnapshot(const BasicOrderbook<Levels>& orderbook, const std::string& path, std::uint64_t journalPosition = 0);
+
+// Maps a snapshot read-only and validates its header and length. Throws
+// std::system_error if it cannot be mapped and std::runtime_error if it is
+// not a complete snapshot of a supported version.
+class SnapshotReader
+{
+private:
+    MappedFile file_;
+    const SnapshotHeader* header_;
+    std::span<const SnapshotOrder> orders_;
+
+public:
+    explicit SnapshotReader(const std::string& path);
+
+    std::span<const SnapshotOrder> Orders() const { return orders_; }
+    std::uint64_t JournalPosition() const { return header_->journalPosition_; }
+};
+
+// Bulk-loads a snapshot into an empty book without matching, reporting level
+// changes and publishing depth once at the end. Throws std::logic_error if the
+// book is not empty and std::runtime_error if the snapshot holds an invalid or
+// duplicate order. Either way the book is left as it was, so a failed load
+// can be retried into the same book.
+template <typename Levels>
+void LoadSnapshot(const SnapshotReader& snapshot, BasicOrderbook<Levels>& orderbook);
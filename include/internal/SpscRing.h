@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Bounded single-producer/single-consumer queue. The write and read indices sit
+// on separate cache lines, and each side keeps a cached copy of the other's
+// index so the shared line is only re-read when the ring looks full or empty.
+template <typename T>
+class SpscRing
+{
+private:
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    static constexpr std::size_t CacheLineSize = 64;
+
+    struct Slot
+    {
+        alignas(T) std::byte storage_[sizeof(T)];
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_;
+
+    alignas(CacheLineSize) std::atomic<std::size_t> head_{ };
+    std::size_t cachedTail_{ };
+
+    alignas(CacheLineSize) std::atomic<std::size_t> tail_{ };
+    std::size_t cachedHead_{ };
+
+public:
+    // Capacity is rounded up to a power of two.
+    explicit SpscRing(std::size_t capacity)
+        : slots_{ std::make_unique_for_overwrite<Slot[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2))) }
+        , mask_{ std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1 }
+    { }
+
+    SpscRing(const SpscRing&) = delete;
+    void operator=(const SpscRing&) = delete;
+
+    std::size_t Capacity() const { return mask_ + 1; }
+
+    bool Empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    // Producer side. Returns false if the ring is full.
+    bool TryPush(const T& value)
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ == Capacity())
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ == Capacity())
+                return false;
+        }
+
+        std::memcpy(slots_[head & mask_].storage_, &value, sizeof(T));
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the ring is empty.
+    bool TryPop(T& value)
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cachedHead_)
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail == cachedHead_)
+                return false;
+        }
+
+        std::memcpy(&value, slots_[tail & mask_].storage_, sizeof(T));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+};
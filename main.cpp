@@ -1,5 +1,6 @@
 #include "internal/Orderbook.h"
 #include "internal/MarketDataFeedHandler.h"
+#include "internal/Instrumentation.h"
 
 #include <iostream>
 #include <string>
@@ -27,7 +28,7 @@ void displayOrderbookInfo(const Orderbook& orderbook) {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
         MarketDataFeedHandler feedHandler;
         
@@ -35,6 +36,32 @@ int main() {
             std::cerr << "Failed to initialize handler: " << feedHandler.getLastError() << std::endl;
             return 1;
         }
+
+        std::string capturePath;
+        std::string replayPath;
+        ReplaySpeed replaySpeed = ReplaySpeed::Maximum;
+        for (int i = 1; i < argc; ++i) {
+            std::string argument = argv[i];
+            if (argument == "--capture" && i + 1 < argc) {
+                capturePath = argv[++i];
+            } else if (argument == "--replay" && i + 1 < argc) {
+                replayPath = argv[++i];
+            } else if (argument == "--recorded-speed") {
+                replaySpeed = ReplaySpeed::Recorded;
+            } else {
+                std::cerr << "Usage: " << argv[0] << " [--capture <file> | --replay <file> [--recorded-speed]]" << std::endl;
+                return 1;
+            }
+        }
+
+        if (!capturePath.empty() && !feedHandler.startCapture(capturePath)) {
+            std::cerr << feedHandler.getLastError() << std::endl;
+            return 1;
+        }
+        if (!replayPath.empty() && !feedHandler.startReplay(replayPath, replaySpeed)) {
+            std::cerr << feedHandler.getLastError() << std::endl;
+            return 1;
+        }
         
         std::string ticker = "KXPRESPERSON-28-GNEWS";
         std::cout << "Enter ticker (or press Enter for default '" << ticker << "'): ";
@@ -88,5 +115,10 @@ int main() {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
+
+#if defined(MORNINGSIDE_INSTRUMENTATION)
+    std::cout << "\n--- Hot-Path Metrics ---" << std::endl;
+    DumpMetrics(TakeMetricsSnapshot(), std::cout);
+#endif
     return 0;
 }
\ No newline at end of file
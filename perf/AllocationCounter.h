@@ -0,0 +1,133 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocator of the benchmark binary, so this header must be
+// included by exactly one translation unit per executable. Every form of
+// operator new is counted, and every replacement is kept out of line so the
+// compiler pairs each new with its delete instead of seeing through only one.
+inline std::atomic<std::uint64_t> allocationCount{ 0 };
+
+inline void* CountedAllocate(std::size_t size, std::size_t alignment) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0)
+        size = 1;
+    if (alignment <= alignof(std::max_align_t))
+        return std::malloc(size);
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+inline void* CountedAllocateOrThrow(std::size_t size, std::size_t alignment)
+{
+    if (void* memory = CountedAllocate(size, alignment))
+        return memory;
+    throw std::bad_alloc{ };
+}
+
+[[gnu::noinline]] void* operator new(std::size_t size)
+{
+    return CountedAllocateOrThrow(size, alignof(std::max_align_t));
+}
+[[gnu::noinline]] void* operator new[](std::size_t size)
+{
+    return CountedAllocateOrThrow(size, alignof(std::max_align_t));
+}
+[[gnu::noinline]] void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return CountedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+[[gnu::noinline]] void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return CountedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+[[gnu::noinline]] void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size, alignof(std::max_align_t));
+}
+[[gnu::noinline]] void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size, alignof(std::max_align_t));
+}
+[[gnu::noinline]] void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+[[gnu::noinline]] void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+[[gnu::noinline]] void operator delete(void* memory) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete[](void* memory) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { std::free(memory); }
+
+// Reports heap allocations per operation made while the benchmark timer runs.
+// Use its PauseTiming/ResumeTiming in place of the ones on benchmark::State so
+// setup work is excluded from the count.
+class AllocationCounter
+{
+public:
+    explicit AllocationCounter(benchmark::State& state, std::int64_t operationsPerIteration = 1)
+        : state_{ state }
+        , operationsPerIteration_{ operationsPerIteration }
+        , start_{ allocationCount.load(std::memory_order_relaxed) }
+    { }
+
+    ~AllocationCounter()
+    {
+        state_.counters["allocs/op"] = benchmark::Counter(
+            static_cast<double>(Allocations()) / static_cast<double>(operationsPerIteration_),
+            benchmark::Counter::kAvgIterations);
+    }
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    void operator=(const AllocationCounter&) = delete;
+
+    // Allocations made while timing so far.
+    std::uint64_t Allocations() const
+    {
+        return allocationCount.load(std::memory_order_relaxed) - start_ - excluded_;
+    }
+
+    // Fails the benchmark if anything was allocated while timing.
+    void ExpectNoAllocations()
+    {
+        if (Allocations() != 0)
+            state_.SkipWithError("expected no allocations on this path");
+    }
+
+    void PauseTiming()
+    {
+        state_.PauseTiming();
+        pausedAt_ = allocationCount.load(std::memory_order_relaxed);
+    }
+
+    void ResumeTiming()
+    {
+        excluded_ += allocationCount.load(std::memory_order_relaxed) - pausedAt_;
+        state_.ResumeTiming();
+    }
+
+private:
+    benchmark::State& state_;
+    std::int64_t operationsPerIteration_;
+    std::uint64_t start_;
+    std::uint64_t excluded_{ };
+    std::uint64_t pausedAt_{ };
+};
@@ -0,0 +1,132 @@
+#include "internal/ConsolidatedOrderbook.h"
+#include "AllocationCounter.h"
+
+#include <benchmark/benchmark.h>
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+struct LevelUpdate
+{
+    std::size_t source_;
+    Side side_;
+    Price price_;
+    Quantity quantity_;
+};
+
+// Level updates spread over the sources, with bids below 50 and asks above as
+// each source quotes them, and one update in five removing a level.
+static std::vector<LevelUpdate> MakeLevelUpdates(std::size_t count, std::size_t sources)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<Price> bidDist(30, 49);
+    std::uniform_int_distribution<Price> askDist(50, 70);
+    std::uniform_int_distribution<Quantity> quantityDist(1, 500);
+    std::vector<LevelUpdate> updates;
+    updates.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Side side = rng() % 2 ? Side::Buy : Side::Sell;
+        Price price = side == Side::Buy ? bidDist(rng) : askDist(rng);
+        updates.push_back({ i % sources, side, price, rng() % 5 == 0 ? 0 : quantityDist(rng) });
+    }
+    return updates;
+}
+
+// Sources 0 and 1 quote YES; the last one quotes the complementary NO book.
+static void AddSources(ConsolidatedOrderbook& orderbook, std::size_t sources)
+{
+    for (std::size_t i = 0; i < sources; ++i)
+        orderbook.AddSource(i + 1 == sources);
+}
+
+static void BM_ConsolidatedSetLevel(benchmark::State& state)
+{
+    const std::size_t sources = state.range(0);
+    const auto updates = MakeLevelUpdates(1 << 16, sources);
+    ConsolidatedOrderbook orderbook;
+    AddSources(orderbook, sources);
+    std::size_t next = 0;
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        const auto& update = updates[next++ & (updates.size() - 1)];
+        orderbook.SetLevel(update.source_, update.side_, update.price_, update.quantity_);
+        benchmark::DoNotOptimize(orderbook.GetBestBid());
+        benchmark::DoNotOptimize(orderbook.GetBestAsk());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConsolidatedSetLevel)->Arg(2)->Arg(4)->Arg(8);
+
+// Baseline: keep only the source books and merge them for every read of the
+// consolidated top of book.
+static void BM_MergeSourcesOnRead(benchmark::State& state)
+{
+    const std::size_t sources = state.range(0);
+    const auto updates = MakeLevelUpdates(1 << 16, sources);
+    std::vector<std::unique_ptr<LevelOrderbook>> orderbooks;
+    for (std::size_t i = 0; i < sources; ++i)
+        orderbooks.push_back(std::make_unique<LevelOrderbook>());
+    std::size_t next = 0;
+
+    for (auto _ : state)
+    {
+        const auto& update = updates[next++ & (updates.size() - 1)];
+        orderbooks[update.source_]->SetLevel(update.side_, update.price_, update.quantity_);
+
+        std::array<Quantity, KalshiMaxPrice + 1> bids{ }, asks{ };
+        for (std::size_t i = 0; i < sources; ++i)
+        {
+            bool complement = i + 1 == sources;
+            for (Price price = KalshiMinPrice; price <= KalshiMaxPrice; ++price)
+            {
+                Price merged = complement ? 100 - price : price;
+                (complement ? asks : bids)[merged] += orderbooks[i]->GetLevel(Side::Buy, price);
+                (complement ? bids : asks)[merged] += orderbooks[i]->GetLevel(Side::Sell, price);
+            }
+        }
+
+        Price bestBid = KalshiMaxPrice;
+        while (bestBid >= KalshiMinPrice && bids[bestBid] == 0)
+            --bestBid;
+        Price bestAsk = KalshiMinPrice;
+        while (bestAsk <= KalshiMaxPrice && asks[bestAsk] == 0)
+            ++bestAsk;
+        benchmark::DoNotOptimize(bestBid);
+        benchmark::DoNotOptimize(bestAsk);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MergeSourcesOnRead)->Arg(2)->Arg(4)->Arg(8);
+
+// A REST snapshot of one source in which a handful of levels changed.
+static void BM_ConsolidatedReplaceSource(benchmark::State& state)
+{
+    const auto updates = MakeLevelUpdates(1 << 12, 1);
+    ConsolidatedOrderbook orderbook;
+    AddSources(orderbook, 4);
+    std::array<std::unique_ptr<LevelOrderbook>, 2> snapshots{ std::make_unique<LevelOrderbook>(), std::make_unique<LevelOrderbook>() };
+    for (const auto& update : updates)
+    {
+        snapshots[0]->SetLevel(update.side_, update.price_, update.quantity_);
+        snapshots[1]->SetLevel(update.side_, update.price_, update.quantity_);
+    }
+    for (std::size_t i = 0; i < 8; ++i)
+        snapshots[1]->SetLevel(updates[i].side_, updates[i].price_, updates[i].quantity_ + 1);
+    std::size_t next = 0;
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        orderbook.ReplaceSource(0, *snapshots[next++ & 1]);
+        benchmark::DoNotOptimize(orderbook.GetBestBid());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConsolidatedReplaceSource);
+
+BENCHMARK_MAIN();
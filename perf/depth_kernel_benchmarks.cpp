@@ -0,0 +1,137 @@
+#include "internal/Orderbook.h"
+#include "internal/DepthKernels.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+// Arg 0 runs the scalar kernels, arg 1 the AVX2 ones.
+static const DepthKernels* SelectKernels(benchmark::State& state)
+{
+    const DepthKernels* kernels = state.range(0) ? DepthKernels::Avx2() : &DepthKernels::Scalar();
+    if (!kernels)
+        state.SkipWithError("AVX2 is not available");
+    return kernels;
+}
+
+// One quantity per tick, about a third of them empty.
+static std::vector<Quantity> MakeQuantities(std::size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<Quantity> quantity_dist(1, 1000);
+    std::vector<Quantity> quantities(count);
+    for (auto& quantity : quantities)
+        quantity = rng() % 3 == 0 ? 0 : quantity_dist(rng);
+    return quantities;
+}
+
+static void BM_KernelSum(benchmark::State& state)
+{
+    auto* kernels = SelectKernels(state);
+    if (!kernels)
+        return;
+
+    const auto quantities = MakeQuantities(static_cast<std::size_t>(state.range(1)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(quantities.data());
+        benchmark::DoNotOptimize(kernels->sum_(quantities));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_KernelSum)->ArgsProduct({ { 0, 1 }, { 99, 1024 } });
+
+static void BM_KernelPrefixSums(benchmark::State& state)
+{
+    auto* kernels = SelectKernels(state);
+    if (!kernels)
+        return;
+
+    const auto quantities = MakeQuantities(static_cast<std::size_t>(state.range(1)));
+    std::vector<std::uint64_t> sums(quantities.size());
+    for (auto _ : state)
+    {
+        kernels->prefixSums_(quantities, sums.data(), 0);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_KernelPrefixSums)->ArgsProduct({ { 0, 1 }, { 99, 1024 } });
+
+// Takes range(1) percent of the total from the back of 99 ticks, as a sell
+// sweeping the bids does.
+static void BM_KernelSweep(benchmark::State& state)
+{
+    auto* kernels = SelectKernels(state);
+    if (!kernels)
+        return;
+
+    const auto quantities = MakeQuantities(99);
+    const std::uint64_t quantity = DepthKernels::Scalar().sum_(quantities) * static_cast<std::uint64_t>(state.range(1)) / 100;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(quantities.data());
+        benchmark::DoNotOptimize(kernels->sweepBackward_(quantities, quantity));
+    }
+}
+BENCHMARK(BM_KernelSweep)->ArgsProduct({ { 0, 1 }, { 1, 25, 100 } });
+
+// Bids on every tick from 1 to 49 and asks on every tick from 51 to 99, a few
+// orders each.
+template <typename OrderbookType>
+static void FillLadder(OrderbookType& orderbook)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<Quantity> quantity_dist(1, 100);
+    OrderId orderId = 0;
+    for (Price price = KalshiMinPrice; price <= KalshiMaxPrice; ++price)
+    {
+        if (price == 50)
+            continue;
+        for (int i = 0; i < 4; ++i)
+            orderbook.AddOrder(OrderType::GoodTillCancel, ++orderId, price < 50 ? Side::Buy : Side::Sell, price, quantity_dist(rng));
+    }
+}
+
+// How much a buy could take up to the worst ask.
+template <typename OrderbookType>
+static void BM_GetFillableQuantity(benchmark::State& state)
+{
+    OrderbookType orderbook;
+    FillLadder(orderbook);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(orderbook.GetFillableQuantity(Side::Buy, KalshiMaxPrice));
+}
+BENCHMARK_TEMPLATE(BM_GetFillableQuantity, Orderbook);
+BENCHMARK_TEMPLATE(BM_GetFillableQuantity, LadderOrderbook);
+
+// VWAP of a sell for range(0) contracts. Each level holds about 200.
+template <typename OrderbookType>
+static void BM_GetSweepCost(benchmark::State& state)
+{
+    OrderbookType orderbook;
+    FillLadder(orderbook);
+    const auto quantity = static_cast<std::uint64_t>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(orderbook.GetSweepCost(Side::Sell, quantity).AveragePrice());
+}
+BENCHMARK_TEMPLATE(BM_GetSweepCost, Orderbook)->Arg(100)->Arg(2000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_GetSweepCost, LadderOrderbook)->Arg(100)->Arg(2000)->Arg(100000);
+
+// Fillable quantity at every tick of the range, for a slippage curve.
+template <typename OrderbookType>
+static void BM_GetCumulativeDepth(benchmark::State& state)
+{
+    OrderbookType orderbook;
+    FillLadder(orderbook);
+    std::vector<std::uint64_t> depth(KalshiMaxPrice - KalshiMinPrice + 1);
+    for (auto _ : state)
+    {
+        orderbook.GetCumulativeDepth(Side::Sell, KalshiMinPrice, depth);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_TEMPLATE(BM_GetCumulativeDepth, Orderbook);
+BENCHMARK_TEMPLATE(BM_GetCumulativeDepth, LadderOrderbook);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,120 @@
+#include "internal/Orderbook.h"
+#include "AllocationCounter.h"
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <thread>
+
+template <typename OrderbookType>
+static void FillBook(OrderbookType& orderbook, int ordersPerSide)
+{
+    for (int i = 0; i < ordersPerSide; ++i)
+    {
+        orderbook.AddOrder(OrderType::GoodTillCancel, 2 * i + 1, Side::Buy, 49 - i % 40, 10);
+        orderbook.AddOrder(OrderType::GoodTillCancel, 2 * i + 2, Side::Sell, 51 + i % 40, 10);
+    }
+}
+
+// What a strategy thread pays today for the top of the book: two vectors built
+// on the owning thread and copied out.
+template <typename OrderbookType>
+static void BM_PullTopOfBook(benchmark::State& state)
+{
+    OrderbookType orderbook;
+    FillBook(orderbook, 1000);
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(orderbook.GetTopOfBook(static_cast<std::size_t>(state.range(0))));
+}
+BENCHMARK_TEMPLATE(BM_PullTopOfBook, Orderbook)->Arg(1)->Arg(5)->Arg(16);
+BENCHMARK_TEMPLATE(BM_PullTopOfBook, LadderOrderbook)->Arg(1)->Arg(5)->Arg(16);
+
+static void BM_ReadPublishedDepth(benchmark::State& state)
+{
+    DepthPublisher publisher(static_cast<std::size_t>(state.range(0)));
+    LadderOrderbook orderbook;
+    orderbook.SetDepthPublisher(&publisher);
+    FillBook(orderbook, 1000);
+
+    DepthSnapshot snapshot;
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        publisher.Read(snapshot);
+        benchmark::DoNotOptimize(snapshot);
+    }
+    allocations.ExpectNoAllocations();
+}
+BENCHMARK(BM_ReadPublishedDepth)->Arg(1)->Arg(5)->Arg(16);
+
+// The writer-side cost: an add and a cancel at the touch, which republish, or
+// behind the published depth, which only compare. Range(0) is the published
+// depth, 0 meaning no publisher.
+template <typename OrderbookType>
+static void BM_AddCancelPublishing(benchmark::State& state)
+{
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    const bool atTouch = state.range(1) != 0;
+
+    DepthPublisher publisher(depth == 0 ? 1 : depth);
+    OrderbookType orderbook(4096);
+    if (depth != 0)
+        orderbook.SetDepthPublisher(&publisher);
+    FillBook(orderbook, 1000);
+
+    const Price price = atTouch ? 49 : 20;
+    OrderId orderId = 1'000'000;
+    AllocationCounter allocations(state, 2);
+    for (auto _ : state)
+    {
+        orderbook.AddOrder(OrderType::GoodTillCancel, orderId, Side::Buy, price, 5, [](const Trade&) { });
+        orderbook.CancelOrder(orderId);
+        ++orderId;
+    }
+    state.counters["versions/op"] = benchmark::Counter(
+        static_cast<double>(publisher.Version()), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_TEMPLATE(BM_AddCancelPublishing, Orderbook)->ArgsProduct({ { 0, 1, 5, 16 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_AddCancelPublishing, LadderOrderbook)->ArgsProduct({ { 0, 1, 5, 16 }, { 0, 1 } });
+
+// Readers on every benchmark thread while one extra thread keeps amending the
+// touch, so reads regularly overlap publishes and must retry.
+static void BM_ReadDepthUnderWrites(benchmark::State& state)
+{
+    static DepthPublisher publisher(5);
+    static std::atomic<bool> stopping{ };
+    static std::thread writer;
+
+    if (state.thread_index() == 0)
+    {
+        stopping.store(false);
+        writer = std::thread([]
+            {
+                LadderOrderbook orderbook;
+                orderbook.SetDepthPublisher(&publisher);
+                FillBook(orderbook, 100);
+                for (Quantity quantity = 1; !stopping.load(std::memory_order_relaxed); ++quantity)
+                    orderbook.MatchOrder(OrderModify{ 1, Side::Buy, 49, quantity % 10 + 1 }, [](const Trade&) { });
+            });
+    }
+
+    DepthSnapshot snapshot;
+    std::int64_t retries = 0;
+    for (auto _ : state)
+    {
+        while (!publisher.TryRead(snapshot))
+            ++retries;
+        benchmark::DoNotOptimize(snapshot);
+    }
+    state.counters["retries/read"] = benchmark::Counter(static_cast<double>(retries), benchmark::Counter::kAvgIterations);
+
+    if (state.thread_index() == 0)
+    {
+        stopping.store(true);
+        writer.join();
+    }
+}
+BENCHMARK(BM_ReadDepthUnderWrites)->ThreadRange(1, 4)->UseRealTime();
+
+BENCHMARK_MAIN();
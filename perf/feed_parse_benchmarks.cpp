@@ -0,0 +1,321 @@
+#include "internal/ClobAdapter.h"
+#include "internal/KalshiAdapter.h"
+#include "internal/LevelOrderbook.h"
+#include "internal/MarketDataCapture.h"
+#include "internal/MarketDataFeedHandler.h"
+#include "internal/OrderbookJsonParser.h"
+#include "AllocationCounter.h"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using json = nlohmann::json;
+
+// Builds a body in the shape of GET /markets/{ticker}/orderbook, including the
+// *_dollars mirrors the venue sends alongside the integer-cent levels.
+static std::string MakeOrderbookBody(int levels)
+{
+    auto AppendLevels = [](std::string& body, const char* key, int levels, int firstPrice, bool dollars)
+    {
+        body += '"';
+        body += key;
+        body += "\":[";
+        for (int i = 0; i < levels; ++i)
+        {
+            int price = firstPrice + i;
+            int quantity = 100 + (price * 37) % 900;
+            char level[64];
+            if (dollars)
+                std::snprintf(level, sizeof(level), "[\"%d.%04d\",%d]", price / 100, (price % 100) * 100, quantity);
+            else
+                std::snprintf(level, sizeof(level), "[%d,%d]", price, quantity);
+            if (i > 0)
+                body += ',';
+            body += level;
+        }
+        body += ']';
+    };
+
+    std::string body = "{\"orderbook\":{";
+    AppendLevels(body, "yes", levels, 1, false);
+    body += ',';
+    AppendLevels(body, "no", levels, 1, false);
+    body += ',';
+    AppendLevels(body, "yes_dollars", levels, 1, true);
+    body += ',';
+    AppendLevels(body, "no_dollars", levels, 1, true);
+    body += "}}";
+    return body;
+}
+
+static void BM_ParseDomIntoLevelInfos(benchmark::State& state)
+{
+    const std::string body = MakeOrderbookBody(state.range(0));
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        json marketData = json::parse(body);
+        json orderbookData = marketData["orderbook"];
+        LevelInfos bids, asks;
+
+        for (const auto& level : orderbookData["yes"])
+            bids.push_back({ level[0], level[1] });
+        for (const auto& level : orderbookData["no"])
+            asks.push_back({ 100 - level[0].get<Price>(), level[1] });
+
+        benchmark::DoNotOptimize(bids.data());
+        benchmark::DoNotOptimize(asks.data());
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_ParseDomIntoLevelInfos)->Arg(10)->Arg(50)->Arg(99);
+
+static void BM_ParseScannerIntoLevelInfos(benchmark::State& state)
+{
+    const std::string body = MakeOrderbookBody(state.range(0));
+    LevelInfos bids, asks;
+    bids.reserve(KalshiMaxPrice);
+    asks.reserve(KalshiMaxPrice);
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        bids.clear();
+        asks.clear();
+        const char* error = nullptr;
+
+        OrderbookJsonParser::parse(body, [&](bool yes, Price price, Quantity quantity)
+            {
+                if (yes)
+                    bids.push_back({ price, quantity });
+                else
+                    asks.push_back({ 100 - price, quantity });
+            }, error);
+
+        benchmark::DoNotOptimize(bids.data());
+        benchmark::DoNotOptimize(asks.data());
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_ParseScannerIntoLevelInfos)->Arg(10)->Arg(50)->Arg(99);
+
+static void BM_ParseDomIntoLevelOrderbook(benchmark::State& state)
+{
+    const std::string body = MakeOrderbookBody(state.range(0));
+    LevelOrderbook orderbook;
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        json marketData = json::parse(body);
+        json orderbookData = marketData["orderbook"];
+        orderbook.Clear();
+
+        for (const auto& level : orderbookData["yes"])
+            orderbook.SetLevel(Side::Buy, level[0], level[1]);
+        for (const auto& level : orderbookData["no"])
+            orderbook.SetLevel(Side::Sell, 100 - level[0].get<Price>(), level[1]);
+
+        benchmark::DoNotOptimize(orderbook.Size());
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_ParseDomIntoLevelOrderbook)->Arg(10)->Arg(50)->Arg(99);
+
+static void BM_ParseScannerIntoLevelOrderbook(benchmark::State& state)
+{
+    const std::string body = MakeOrderbookBody(state.range(0));
+    LevelOrderbook orderbook;
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        orderbook.Clear();
+        const char* error = nullptr;
+
+        OrderbookJsonParser::parse(body, [&](bool yes, Price price, Quantity quantity)
+            {
+                if (yes)
+                    orderbook.SetLevel(Side::Buy, price, quantity);
+                else
+                    orderbook.SetLevel(Side::Sell, 100 - price, quantity);
+            }, error);
+
+        benchmark::DoNotOptimize(orderbook.Size());
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_ParseScannerIntoLevelOrderbook)->Arg(10)->Arg(50)->Arg(99);
+
+// Builds a body in the shape of a decimal-priced CLOB book, with bids and asks
+// quoted as strings around the middle of the 0-1 range.
+static std::string MakeClobBody(int levels)
+{
+    auto AppendLevels = [](std::string& body, const char* key, int levels, int firstPrice, int step)
+    {
+        body += '"';
+        body += key;
+        body += "\":[";
+        for (int i = 0; i < levels; ++i)
+        {
+            int price = firstPrice + i * step;
+            int size = 100 + (price * 37) % 900;
+            char level[64];
+            std::snprintf(level, sizeof(level), "{\"price\":\"0.%02d\",\"size\":\"%d.25\"}", price, size);
+            if (i > 0)
+                body += ',';
+            body += level;
+        }
+        body += ']';
+    };
+
+    std::string body = "{\"market\":\"0x5f65177b394277fd294cd75650044e32ba009a95022d88a0c1d565897d72f8f1\",\"asset_id\":\"65818619657568813474341868652308942079804919287380422192892211131408793125422\",\"timestamp\":\"1700000000000\",";
+    AppendLevels(body, "bids", levels / 2, 49 - levels / 2 + 1, 1);
+    body += ',';
+    AppendLevels(body, "asks", levels - levels / 2, 50, 1);
+    body += ",\"hash\":\"0xabc\"}";
+    return body;
+}
+
+template <typename Adapter>
+static void BM_DecodeWithAdapter(benchmark::State& state)
+{
+    const std::string body = std::is_same_v<Adapter, ClobAdapter> ? MakeClobBody(state.range(0)) : MakeOrderbookBody(state.range(0));
+    const Adapter adapter;
+    const ExchangeAdapter& venue = adapter;
+    LevelOrderbook orderbook;
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        orderbook.Clear();
+        const char* error = nullptr;
+        if (!venue.decodeOrderbook(body, orderbook, error))
+            state.SkipWithError(error);
+        benchmark::DoNotOptimize(orderbook.Size());
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_DecodeWithAdapter<KalshiAdapter>)->Arg(10)->Arg(50)->Arg(98);
+BENCHMARK(BM_DecodeWithAdapter<ClobAdapter>)->Arg(10)->Arg(50)->Arg(98);
+
+static std::vector<std::string> MakeTickers(int count)
+{
+    std::vector<std::string> tickers;
+    for (int i = 0; i < count; ++i)
+        tickers.push_back("KXBENCH-" + std::to_string(i));
+    return tickers;
+}
+
+// One captured response per ticker, recorded 1ms apart.
+static std::string WriteCapture(const std::vector<std::string>& tickers, int levels)
+{
+    const std::string path = "/tmp/morningside_feed_" + std::to_string(levels) + ".capture";
+    const std::string body = MakeOrderbookBody(levels);
+
+    MarketDataCaptureWriter capture(path);
+    for (std::size_t i = 0; i < tickers.size(); ++i)
+        capture.append(static_cast<std::int64_t>(i) * 1'000'000, tickers[i], 200, body);
+    return path;
+}
+
+// The whole REST ingest path, fed from a capture at maximum speed: ticker
+// lookup, scanning the recorded body and building the book.
+static void BM_ReplayPopulateLevelOrderbook(benchmark::State& state)
+{
+    const auto tickers = MakeTickers(256);
+    const auto path = WriteCapture(tickers, state.range(0));
+    MarketDataFeedHandler feedHandler;
+    if (!feedHandler.startReplay(path, ReplaySpeed::Maximum))
+    {
+        state.SkipWithError(feedHandler.getLastError().c_str());
+        return;
+    }
+    LevelOrderbook orderbook;
+    std::size_t next = 0;
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        if (next == tickers.size())
+        {
+            allocations.PauseTiming();
+            feedHandler.rewindReplay();
+            next = 0;
+            allocations.ResumeTiming();
+        }
+        if (!feedHandler.populateOrderbook(orderbook, tickers[next++]))
+            state.SkipWithError(feedHandler.getLastError().c_str());
+        benchmark::DoNotOptimize(orderbook.Size());
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ReplayPopulateLevelOrderbook)->Arg(10)->Arg(50)->Arg(99);
+
+static void BM_ReplayPopulateOrderbook(benchmark::State& state)
+{
+    const auto tickers = MakeTickers(256);
+    const auto path = WriteCapture(tickers, state.range(0));
+    MarketDataFeedHandler feedHandler;
+    if (!feedHandler.startReplay(path, ReplaySpeed::Maximum))
+    {
+        state.SkipWithError(feedHandler.getLastError().c_str());
+        return;
+    }
+    std::size_t next = 0;
+
+    for (auto _ : state)
+    {
+        if (next == tickers.size())
+        {
+            state.PauseTiming();
+            feedHandler.rewindReplay();
+            next = 0;
+            state.ResumeTiming();
+        }
+        Orderbook orderbook;
+        if (!feedHandler.populateOrderbook(orderbook, tickers[next++]))
+            state.SkipWithError(feedHandler.getLastError().c_str());
+        benchmark::DoNotOptimize(orderbook.Size());
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ReplayPopulateOrderbook)->Arg(10)->Arg(50)->Arg(99);
+
+// Batch path over all 256 tickers per iteration.
+static void BM_ReplayPopulateOrderbooks(benchmark::State& state)
+{
+    const auto tickers = MakeTickers(256);
+    const auto path = WriteCapture(tickers, state.range(0));
+    MarketDataFeedHandler feedHandler;
+    if (!feedHandler.startReplay(path, ReplaySpeed::Maximum))
+    {
+        state.SkipWithError(feedHandler.getLastError().c_str());
+        return;
+    }
+    std::vector<std::unique_ptr<LevelOrderbook>> storage;
+    std::vector<LevelOrderbook*> orderbooks;
+    for (std::size_t i = 0; i < tickers.size(); ++i)
+        orderbooks.push_back(storage.emplace_back(std::make_unique<LevelOrderbook>()).get());
+
+    AllocationCounter allocations(state, tickers.size());
+    for (auto _ : state)
+    {
+        feedHandler.rewindReplay();
+        if (feedHandler.populateOrderbooks(tickers, orderbooks) != tickers.size())
+            state.SkipWithError(feedHandler.getLastError().c_str());
+    }
+    state.SetItemsProcessed(state.iterations() * tickers.size());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ReplayPopulateOrderbooks)->Arg(10)->Arg(50)->Arg(99);
+
+BENCHMARK_MAIN();
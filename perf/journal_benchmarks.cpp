@@ -0,0 +1,118 @@
+#include "internal/Journal.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::string JournalPath(const char* name)
+{
+    return std::string("/tmp/morningside_") + name + ".journal";
+}
+
+static std::vector<OrderbookCommand> MakeJournalCommands(std::size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<> op_dist(1, 10);
+    std::uniform_int_distribution<> price_dist(30, 70);
+    std::vector<OrderbookCommand> commands;
+    commands.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        int op = op_dist(rng);
+        Side side = i % 2 == 0 ? Side::Buy : Side::Sell;
+        if (op <= 6 || i == 0)
+            commands.push_back({ OrderbookCommand::Action::Add, OrderType::GoodTillCancel, i, side, price_dist(rng), 10 });
+        else if (op <= 9)
+            commands.push_back({ OrderbookCommand::Action::Cancel, OrderType::GoodTillCancel, rng() % i, side, 0, 0 });
+        else
+            commands.push_back({ OrderbookCommand::Action::Modify, OrderType::GoodTillCancel, rng() % i, side, price_dist(rng), 5 });
+    }
+    return commands;
+}
+
+template <typename OrderbookType>
+static void BM_ApplyUnjournaled(benchmark::State& state)
+{
+    const auto commands = MakeJournalCommands(1 << 16);
+    std::uint64_t trades = 0;
+    auto onTrade = [&trades](const Trade&) { ++trades; };
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto orderbook = std::make_unique<OrderbookType>(commands.size());
+        state.ResumeTiming();
+
+        for (const auto& command : commands)
+            orderbook->ApplyBatch(std::span<const OrderbookCommand>{ &command, 1 }, onTrade);
+    }
+    state.SetItemsProcessed(state.iterations() * commands.size());
+}
+BENCHMARK_TEMPLATE(BM_ApplyUnjournaled, Orderbook);
+BENCHMARK_TEMPLATE(BM_ApplyUnjournaled, LadderOrderbook);
+
+// Journals every command and the trades it produces, as a recovering book would.
+template <typename OrderbookType, JournalSync Sync>
+static void BM_ApplyJournaled(benchmark::State& state)
+{
+    const auto commands = MakeJournalCommands(1 << 16);
+    const auto path = JournalPath("bench");
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::remove(path.c_str());
+        auto orderbook = std::make_unique<OrderbookType>(commands.size());
+        JournalWriter journal(path, Sync, state.range(0));
+        state.ResumeTiming();
+
+        for (const auto& command : commands)
+        {
+            journal.Append(command);
+            orderbook->ApplyBatch(std::span<const OrderbookCommand>{ &command, 1 }, journal);
+        }
+        journal.Flush();
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * commands.size());
+}
+BENCHMARK_TEMPLATE(BM_ApplyJournaled, LadderOrderbook, JournalSync::None)->Arg(256)->Arg(4096)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_ApplyJournaled, LadderOrderbook, JournalSync::OnFlush)->Arg(256)->Arg(4096)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_ApplyJournaled, Orderbook, JournalSync::OnFlush)->Arg(4096);
+
+template <typename OrderbookType>
+static void BM_ReplayJournal(benchmark::State& state)
+{
+    const auto path = JournalPath("replay");
+    std::remove(path.c_str());
+    {
+        const auto commands = MakeJournalCommands(state.range(0));
+        OrderbookType orderbook(commands.size());
+        JournalWriter journal(path, JournalSync::None);
+        for (const auto& command : commands)
+        {
+            journal.Append(command);
+            orderbook.ApplyBatch(std::span<const OrderbookCommand>{ &command, 1 }, journal);
+        }
+    }
+
+    JournalReader reader(path);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto orderbook = std::make_unique<OrderbookType>(reader.Records().size());
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(ReplayJournal(reader.Records(), *orderbook));
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * reader.Records().size());
+    state.SetBytesProcessed(state.iterations() * reader.Records().size_bytes());
+}
+BENCHMARK_TEMPLATE(BM_ReplayJournal, Orderbook)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ReplayJournal, LadderOrderbook)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+#include "internal/Orderbook.h"
+#include "internal/LevelChangeListener.h"
+#include "internal/LevelOrderbook.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+static std::vector<OrderbookCommand> MakeCommands(std::size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<> op_dist(1, 10);
+    std::uniform_int_distribution<> price_dist(30, 70);
+    std::vector<OrderbookCommand> commands;
+    commands.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        int op = op_dist(rng);
+        Side side = i % 2 == 0 ? Side::Buy : Side::Sell;
+        Price price = side == Side::Buy ? price_dist(rng) - 10 : price_dist(rng) + 10;
+        if (op <= 5 || i == 0)
+            commands.push_back({ OrderbookCommand::Action::Add, OrderType::GoodTillCancel, i, side, price, 10 });
+        else if (op <= 8)
+            commands.push_back({ OrderbookCommand::Action::Cancel, OrderType::GoodTillCancel, rng() % i, side, 0, 0 });
+        else if (op <= 9)
+            commands.push_back({ OrderbookCommand::Action::Modify, OrderType::GoodTillCancel, rng() % i, side, price, 5 });
+        else
+            commands.push_back({ OrderbookCommand::Action::Add, OrderType::FillAndKill, i, side, side == Side::Buy ? 70 : 30, 20 });
+    }
+    return commands;
+}
+
+class CountingListener final : public LevelChangeListener
+{
+public:
+    std::uint64_t changes_{ };
+
+    void OnLevelChanges(std::span<const LevelChange> changes) override { changes_ += changes.size(); }
+};
+
+// Keeps a level mirror current from the change stream: O(changes) per command.
+template <typename OrderbookType>
+static void BM_MirrorByLevelChanges(benchmark::State& state)
+{
+    const auto commands = MakeCommands(1 << 16);
+    std::uint64_t changes = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto orderbook = std::make_unique<OrderbookType>(commands.size());
+        LevelOrderbook mirror;
+        LevelOrderbookMirror listener(mirror);
+        CountingListener counter;
+        LevelChangeFanout fanout;
+        fanout.Subscribe(&listener);
+        fanout.Subscribe(&counter);
+        orderbook->SetLevelChangeListener(&fanout);
+        state.ResumeTiming();
+
+        for (const auto& command : commands)
+            orderbook->ApplyBatch({ &command, 1 }, [](const Trade&) { });
+
+        changes += counter.changes_;
+        benchmark::DoNotOptimize(mirror.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(commands.size()));
+    state.counters["changes/cmd"] = benchmark::Counter(
+        static_cast<double>(changes) / static_cast<double>(commands.size()), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_TEMPLATE(BM_MirrorByLevelChanges, Orderbook)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MirrorByLevelChanges, LadderOrderbook)->Unit(benchmark::kMillisecond);
+
+// The alternative without the stream: pull a full snapshot after each command
+// and rewrite the mirror from it.
+template <typename OrderbookType>
+static void BM_MirrorBySnapshot(benchmark::State& state)
+{
+    const auto commands = MakeCommands(1 << 16);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto orderbook = std::make_unique<OrderbookType>(commands.size());
+        LevelOrderbook mirror;
+        state.ResumeTiming();
+
+        for (const auto& command : commands)
+        {
+            orderbook->ApplyBatch({ &command, 1 }, [](const Trade&) { });
+            auto infos = orderbook->GetOrderInfos();
+            mirror.Clear();
+            for (const auto& level : infos.GetBids())
+                mirror.SetLevel(Side::Buy, level.price_, level.quantity_);
+            for (const auto& level : infos.GetAsks())
+                mirror.SetLevel(Side::Sell, level.price_, level.quantity_);
+        }
+        benchmark::DoNotOptimize(mirror.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(commands.size()));
+}
+BENCHMARK_TEMPLATE(BM_MirrorBySnapshot, Orderbook)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MirrorBySnapshot, LadderOrderbook)->Unit(benchmark::kMillisecond);
+
+// What the stream costs the matching thread: the same commands with no
+// listener, and with range(0) subscribers behind a fanout.
+template <typename OrderbookType>
+static void BM_ApplyWithLevelChanges(benchmark::State& state)
+{
+    const auto commands = MakeCommands(1 << 16);
+    const auto subscribers = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto orderbook = std::make_unique<OrderbookType>(commands.size());
+        std::vector<CountingListener> listeners(subscribers);
+        LevelChangeFanout fanout;
+        for (auto& listener : listeners)
+            fanout.Subscribe(&listener);
+        if (subscribers > 0)
+            orderbook->SetLevelChangeListener(&fanout);
+        state.ResumeTiming();
+
+        orderbook->ApplyBatch(commands, [](const Trade&) { });
+        benchmark::DoNotOptimize(orderbook->Size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(commands.size()));
+}
+BENCHMARK_TEMPLATE(BM_ApplyWithLevelChanges, Orderbook)->Arg(0)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ApplyWithLevelChanges, LadderOrderbook)->Arg(0)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
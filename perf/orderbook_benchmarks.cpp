@@ -1,132 +1,269 @@
 #include "internal/Orderbook.h"
+#include "AllocationCounter.h"
 
 #include <benchmark/benchmark.h>
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <random>
+#include <vector>
 
+template <typename OrderbookType>
 static void BM_SimpleAddOrder(benchmark::State& state)
 {
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
-        Orderbook orderbook;
-        auto order = std::make_shared<Order>(
-            OrderType::GoodTillCancel, 1, Side::Buy, 100, 10);
-        benchmark::DoNotOptimize(orderbook.AddOrder(order));
+        OrderbookType orderbook;
+        benchmark::DoNotOptimize(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 50, 10));
     }
 }
-BENCHMARK(BM_SimpleAddOrder);
+BENCHMARK_TEMPLATE(BM_SimpleAddOrder, Orderbook);
+BENCHMARK_TEMPLATE(BM_SimpleAddOrder, LadderOrderbook);
 
+template <typename OrderbookType>
 static void BM_AddOrderNoMatch(benchmark::State& state)
 {
+    AllocationCounter allocations(state, state.range(0));
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
-        state.ResumeTiming();
+        allocations.PauseTiming();
+        OrderbookType orderbook;
+        allocations.ResumeTiming();
         
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            benchmark::DoNotOptimize(orderbook.AddOrder(
+                OrderType::GoodTillCancel,
+                static_cast<uint64_t>(i) + 1000000,
+                i % 2 == 0 ? Side::Buy : Side::Sell,
+                i % 2 == 0 ? 1 + i % 49 : 50 + i % 50,
+                10
+            ));
+        }
+    }
+}
+BENCHMARK_TEMPLATE(BM_AddOrderNoMatch, Orderbook)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_AddOrderNoMatch, LadderOrderbook)->RangeMultiplier(2)->Range(10, 1000);
+
+template <typename OrderbookType>
+static void BM_AddOrderPointerNoMatch(benchmark::State& state)
+{
+    AllocationCounter allocations(state, state.range(0));
+    for (auto _ : state)
+    {
+        allocations.PauseTiming();
+        OrderbookType orderbook;
+        allocations.ResumeTiming();
+
         for (int i = 0; i < state.range(0); ++i)
         {
             auto order = std::make_shared<Order>(
                 OrderType::GoodTillCancel,
                 static_cast<uint64_t>(i) + 1000000,
                 i % 2 == 0 ? Side::Buy : Side::Sell,
-                100 + i,
+                i % 2 == 0 ? 1 + i % 49 : 50 + i % 50,
                 10
             );
             benchmark::DoNotOptimize(orderbook.AddOrder(order));
         }
     }
 }
-BENCHMARK(BM_AddOrderNoMatch)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_AddOrderPointerNoMatch, Orderbook)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_AddOrderPointerNoMatch, LadderOrderbook)->RangeMultiplier(2)->Range(10, 1000);
+
+// The hot no-match add path: the book already has every price level and enough
+// pool and index capacity, and fills go to a sink, so adding must not allocate.
+template <typename OrderbookType>
+static void BM_AddOrderNoMatchSink(benchmark::State& state)
+{
+    OrderbookType orderbook(state.range(0) + 100);
+    for (Price price = 1; price < 100; ++price)
+        orderbook.AddOrder(OrderType::GoodTillCancel, price, price < 50 ? Side::Buy : Side::Sell, price, 10);
+
+    std::uint64_t trades = 0;
+    auto onTrade = [&trades](const Trade&) { ++trades; };
+    auto addOrders = [&]
+    {
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            orderbook.AddOrder(
+                OrderType::GoodTillCancel,
+                static_cast<uint64_t>(i) + 1000000,
+                i % 2 == 0 ? Side::Buy : Side::Sell,
+                i % 2 == 0 ? 1 + i % 49 : 50 + i % 50,
+                10,
+                onTrade
+            );
+        }
+    };
+    auto cancelOrders = [&]
+    {
+        for (int i = 0; i < state.range(0); ++i)
+            orderbook.CancelOrder(static_cast<uint64_t>(i) + 1000000);
+    };
+
+    addOrders();
+    cancelOrders();
+
+    AllocationCounter allocations(state, state.range(0));
+    for (auto _ : state)
+    {
+        addOrders();
+
+        allocations.PauseTiming();
+        cancelOrders();
+        allocations.ResumeTiming();
+    }
+    allocations.ExpectNoAllocations();
+    benchmark::DoNotOptimize(trades);
+}
+BENCHMARK_TEMPLATE(BM_AddOrderNoMatchSink, Orderbook)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_AddOrderNoMatchSink, LadderOrderbook)->RangeMultiplier(2)->Range(10, 1000);
 
+template <typename OrderbookType>
 static void BM_AddOrderWithFullMatch(benchmark::State& state)
 {
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
+        allocations.PauseTiming();
+        OrderbookType orderbook;
 
         for (int i = 0; i < state.range(0); ++i)
         {
-            auto order = std::make_shared<Order>(
+            orderbook.AddOrder(
                 OrderType::GoodTillCancel,
                 static_cast<uint64_t>(i),
                 Side::Buy,
-                100,
+                50,
                 10
             );
-            orderbook.AddOrder(order);
         }
-        state.ResumeTiming();
+        allocations.ResumeTiming();
         
-        auto sell = std::make_shared<Order>(
+        benchmark::DoNotOptimize(orderbook.AddOrder(
             OrderType::GoodTillCancel,
             static_cast<uint64_t>(state.range(0)) + 1000000,
             Side::Sell,
-            100,
+            50,
             10 * state.range(0)
-        );
-        benchmark::DoNotOptimize(orderbook.AddOrder(sell));
+        ));
     }
 }
-BENCHMARK(BM_AddOrderWithFullMatch)->RangeMultiplier(2)->Range(10, 100);
+BENCHMARK_TEMPLATE(BM_AddOrderWithFullMatch, Orderbook)->RangeMultiplier(2)->Range(10, 100)->Arg(10000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_AddOrderWithFullMatch, LadderOrderbook)->RangeMultiplier(2)->Range(10, 100)->Arg(10000)->Arg(100000);
 
+template <typename OrderbookType>
 static void BM_AddOrderWithPartialMatch(benchmark::State& state)
 {
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
+        allocations.PauseTiming();
+        OrderbookType orderbook;
 
         for (int i = 0; i < state.range(0); ++i)
         {
-            auto order = std::make_shared<Order>(
+            orderbook.AddOrder(
                 OrderType::GoodTillCancel,
                 static_cast<uint64_t>(i),
                 Side::Buy,
-                100,
+                50,
                 10
             );
-            orderbook.AddOrder(order);
         }
-        state.ResumeTiming();
+        allocations.ResumeTiming();
         
-        auto sell = std::make_shared<Order>(
+        benchmark::DoNotOptimize(orderbook.AddOrder(
             OrderType::GoodTillCancel,
             static_cast<uint64_t>(state.range(0)) + 1000000,
             Side::Sell,
-            100,
+            50,
             5 * state.range(0)
-        );
-        benchmark::DoNotOptimize(orderbook.AddOrder(sell));
+        ));
     }
 }
-BENCHMARK(BM_AddOrderWithPartialMatch)->RangeMultiplier(2)->Range(10, 100);
+BENCHMARK_TEMPLATE(BM_AddOrderWithPartialMatch, Orderbook)->RangeMultiplier(2)->Range(10, 100)->Arg(10000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_AddOrderWithPartialMatch, LadderOrderbook)->RangeMultiplier(2)->Range(10, 100)->Arg(10000)->Arg(100000);
 
+// One deep level swept by a single order after range(1) percent of its queue
+// was cancelled. With range(2) set, the order pool is churned in random order
+// first, so the level's orders sit in scattered slots as they do in a book
+// that has been running for a while.
+template <typename OrderbookType>
+static void BM_SweepLevelWithCancels(benchmark::State& state)
+{
+    const auto depth = static_cast<int>(state.range(0));
+    const auto cancelled = static_cast<int>(state.range(1));
+    const bool scattered = state.range(2) != 0;
+    std::mt19937 rng(42);
+    std::vector<OrderId> churn;
+
+    std::unique_ptr<OrderbookType> orderbook;
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        allocations.PauseTiming();
+        orderbook = std::make_unique<OrderbookType>(static_cast<std::size_t>(depth) + 1);
+        if (scattered)
+        {
+            churn.clear();
+            for (int i = 0; i < 4 * depth; ++i)
+            {
+                churn.push_back(static_cast<OrderId>(i) + 1000000000);
+                orderbook->AddOrder(OrderType::GoodTillCancel, churn.back(), Side::Buy, 10 + i % 30, 10, [](const Trade&) { });
+            }
+            std::shuffle(churn.begin(), churn.end(), rng);
+            for (auto orderId : churn)
+                orderbook->CancelOrder(orderId);
+        }
+        for (int i = 0; i < depth; ++i)
+            orderbook->AddOrder(OrderType::GoodTillCancel, static_cast<uint64_t>(i), Side::Buy, 50, 10, [](const Trade&) { });
+        for (int i = 0; i < depth; ++i)
+        {
+            if (i % 100 < cancelled)
+                orderbook->CancelOrder(static_cast<uint64_t>(i));
+        }
+        allocations.ResumeTiming();
+
+        orderbook->AddOrder(OrderType::FillAndKill, 2000000000, Side::Sell, 50, 10 * depth, [](const Trade& trade)
+            {
+                benchmark::DoNotOptimize(trade);
+            });
+    }
+    state.SetItemsProcessed(state.iterations() * (depth - depth / 100 * cancelled));
+}
+BENCHMARK_TEMPLATE(BM_SweepLevelWithCancels, Orderbook)->ArgsProduct({ { 10000, 100000 }, { 0, 50, 90 }, { 0, 1 } });
+BENCHMARK_TEMPLATE(BM_SweepLevelWithCancels, LadderOrderbook)->ArgsProduct({ { 10000, 100000 }, { 0, 50, 90 }, { 0, 1 } });
+
+template <typename OrderbookType>
 static void BM_CancelOrderEmpty(benchmark::State& state)
 {
-    Orderbook orderbook;
+    OrderbookType orderbook;
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
         orderbook.CancelOrder(999999);
     }
 }
-BENCHMARK(BM_CancelOrderEmpty);
+BENCHMARK_TEMPLATE(BM_CancelOrderEmpty, Orderbook);
+BENCHMARK_TEMPLATE(BM_CancelOrderEmpty, LadderOrderbook);
 
+template <typename OrderbookType>
 static void BM_CancelOrder(benchmark::State& state)
 {
+    AllocationCounter allocations(state, state.range(0));
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
+        allocations.PauseTiming();
+        OrderbookType orderbook(state.range(0));
 
         for (int i = 0; i < state.range(0); ++i)
         {
-            auto order = std::make_shared<Order>(
-                OrderType::GoodTillCancel, i, Side::Buy, 100, 10);
-            orderbook.AddOrder(order);
+            orderbook.AddOrder(OrderType::GoodTillCancel, i, Side::Buy, 50, 10);
         }
-        state.ResumeTiming();
+        allocations.ResumeTiming();
         
         for (int i = 0; i < state.range(0); ++i)
         {
@@ -134,98 +271,240 @@ static void BM_CancelOrder(benchmark::State& state)
         }
     }
 }
-BENCHMARK(BM_CancelOrder)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_CancelOrder, Orderbook)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK_TEMPLATE(BM_CancelOrder, LadderOrderbook)->RangeMultiplier(10)->Range(10, 1000000);
 
+// Cancels resting orders in random id order from a book of state.range(0)
+// orders, so each lookup lands on a cold slot. The book is built once and each
+// cancelled batch is re-added outside the timed region.
+template <typename OrderbookType>
 static void BM_CancelOrderWorstCase(benchmark::State& state)
 {
+    const auto orderCount = static_cast<OrderId>(state.range(0));
+    const auto batchSize = std::min<OrderId>(orderCount, 1024);
+
+    OrderbookType orderbook(orderCount);
+    for (OrderId i = 0; i < orderCount; ++i)
+        orderbook.AddOrder(OrderType::GoodTillCancel, i, Side::Buy, 50, 10);
+
+    std::vector<OrderId> cancelOrder(orderCount);
+    std::iota(cancelOrder.begin(), cancelOrder.end(), OrderId{ 0 });
+    std::shuffle(cancelOrder.begin(), cancelOrder.end(), std::mt19937_64{ 42 });
+
+    std::size_t next = 0;
+    AllocationCounter allocations(state, batchSize);
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
+        if (next + batchSize > cancelOrder.size())
+            next = 0;
 
-        for (int i = 0; i < state.range(0); ++i)
-        {
-            auto order = std::make_shared<Order>(
-                OrderType::GoodTillCancel, i, Side::Buy, 100, 10);
-            orderbook.AddOrder(order);
-        }
-        state.ResumeTiming();
-        
-        orderbook.CancelOrder(state.range(0) / 2);
+        for (OrderId i = 0; i < batchSize; ++i)
+            orderbook.CancelOrder(cancelOrder[next + i]);
+
+        allocations.PauseTiming();
+        for (OrderId i = 0; i < batchSize; ++i)
+            orderbook.AddOrder(OrderType::GoodTillCancel, cancelOrder[next + i], Side::Buy, 50, 10);
+        next += batchSize;
+        allocations.ResumeTiming();
     }
+    state.SetItemsProcessed(state.iterations() * batchSize);
 }
-BENCHMARK(BM_CancelOrderWorstCase)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_CancelOrderWorstCase, Orderbook)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK_TEMPLATE(BM_CancelOrderWorstCase, LadderOrderbook)->RangeMultiplier(10)->Range(10, 1000000);
 
+template <typename OrderbookType>
 static void BM_MatchOrder(benchmark::State& state)
 {
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
-        auto order = std::make_shared<Order>(
-            OrderType::GoodTillCancel, 1, Side::Buy, 100, 10);
-        orderbook.AddOrder(order);
-        state.ResumeTiming();
+        allocations.PauseTiming();
+        OrderbookType orderbook;
+        orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 50, 10);
+        allocations.ResumeTiming();
         
-        OrderModify modify(1, Side::Buy, 101, 20);
+        OrderModify modify(1, Side::Buy, 51, 20);
         benchmark::DoNotOptimize(orderbook.MatchOrder(modify));
     }
 }
-BENCHMARK(BM_MatchOrder);
+BENCHMARK_TEMPLATE(BM_MatchOrder, Orderbook);
+BENCHMARK_TEMPLATE(BM_MatchOrder, LadderOrderbook);
+
+// Resting bids on ten levels, each amended down by one lot at its own price,
+// which keeps the order's place in the queue.
+template <typename OrderbookType>
+static void BM_AmendSizeDown(benchmark::State& state)
+{
+    const int count = state.range(0);
+    OrderbookType orderbook(count);
+    for (int i = 0; i < count; ++i)
+        orderbook.AddOrder(OrderType::GoodTillCancel, i, Side::Buy, 40 + i % 10, 1000000);
+    std::vector<Quantity> quantities(count, 1000000);
+    int next = 0;
 
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        orderbook.MatchOrder(OrderModify(next, Side::Buy, 40 + next % 10, --quantities[next]), [](const Trade&) { });
+        next = next + 1 == count ? 0 : next + 1;
+    }
+    allocations.ExpectNoAllocations();
+}
+BENCHMARK_TEMPLATE(BM_AmendSizeDown, Orderbook)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK_TEMPLATE(BM_AmendSizeDown, LadderOrderbook)->RangeMultiplier(10)->Range(100, 100000);
+
+// The same book, with each amend moving the order one tick and back, so it is
+// requeued at the back of the other level.
+template <typename OrderbookType>
+static void BM_AmendReprice(benchmark::State& state)
+{
+    const int count = state.range(0);
+    OrderbookType orderbook(count);
+    for (int i = 0; i < count; ++i)
+        orderbook.AddOrder(OrderType::GoodTillCancel, i, Side::Buy, 40 + i % 10, 100);
+    std::vector<Price> offsets(count, 0);
+    int next = 0;
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        offsets[next] ^= 10;
+        orderbook.MatchOrder(OrderModify(next, Side::Buy, 40 + next % 10 + offsets[next], 100), [](const Trade&) { });
+        next = next + 1 == count ? 0 : next + 1;
+    }
+}
+BENCHMARK_TEMPLATE(BM_AmendReprice, Orderbook)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK_TEMPLATE(BM_AmendReprice, LadderOrderbook)->RangeMultiplier(10)->Range(100, 100000);
+
+template <typename OrderbookType>
 static void BM_GetOrderInfos(benchmark::State& state)
 {
-    Orderbook orderbook;
+    OrderbookType orderbook;
     for (int i = 0; i < state.range(0); ++i)
     {
-        auto order = std::make_shared<Order>(
+        orderbook.AddOrder(
             OrderType::GoodTillCancel,
             i,
             i % 2 == 0 ? Side::Buy : Side::Sell,
-            100 + (i / 2),
+            1 + (i / 2) % 99,
             10
         );
-        orderbook.AddOrder(order);
     }
     
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
         benchmark::DoNotOptimize(orderbook.GetOrderInfos());
     }
 }
-BENCHMARK(BM_GetOrderInfos)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_GetOrderInfos, Orderbook)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_GetOrderInfos, LadderOrderbook)->RangeMultiplier(2)->Range(10, 1000);
 
+// state.range(0) orders queued on ten levels per side, so the snapshot cost
+// should stay flat as the queues grow.
+template <typename OrderbookType>
+static void BM_GetOrderInfosDeepQueues(benchmark::State& state)
+{
+    OrderbookType orderbook(state.range(0));
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        orderbook.AddOrder(
+            OrderType::GoodTillCancel,
+            i,
+            i % 2 == 0 ? Side::Buy : Side::Sell,
+            i % 2 == 0 ? 40 + i % 10 : 50 + i % 10,
+            10
+        );
+    }
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(orderbook.GetOrderInfos());
+    }
+}
+BENCHMARK_TEMPLATE(BM_GetOrderInfosDeepQueues, Orderbook)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK_TEMPLATE(BM_GetOrderInfosDeepQueues, LadderOrderbook)->RangeMultiplier(10)->Range(100, 100000);
+
+// A FillOrKill buy one lot larger than the ten ask levels hold, so it is
+// rejected after reading every level total. With state.range(0) orders queued
+// across those levels the check should stay flat as the queues grow.
+template <typename OrderbookType>
+static void BM_FillOrKillRejected(benchmark::State& state)
+{
+    OrderbookType orderbook(state.range(0));
+    for (int i = 0; i < state.range(0); ++i)
+        orderbook.AddOrder(OrderType::GoodTillCancel, i, Side::Sell, 50 + i % 10, 10);
+    const Quantity depth = static_cast<Quantity>(state.range(0)) * 10;
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        orderbook.AddOrder(OrderType::FillOrKill, state.range(0), Side::Buy, 99, depth + 1, [](const Trade&) { });
+        benchmark::DoNotOptimize(orderbook.Size());
+    }
+}
+BENCHMARK_TEMPLATE(BM_FillOrKillRejected, Orderbook)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK_TEMPLATE(BM_FillOrKillRejected, LadderOrderbook)->RangeMultiplier(10)->Range(100, 100000);
+
+template <typename OrderbookType>
+static void BM_GetTopOfBook(benchmark::State& state)
+{
+    OrderbookType orderbook;
+    for (int i = 0; i < 1000; ++i)
+    {
+        orderbook.AddOrder(
+            OrderType::GoodTillCancel,
+            i,
+            i % 2 == 0 ? Side::Buy : Side::Sell,
+            i % 2 == 0 ? 1 + i % 49 : 50 + i % 50,
+            10
+        );
+    }
+
+    AllocationCounter allocations(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(orderbook.GetTopOfBook(state.range(0)));
+    }
+}
+BENCHMARK_TEMPLATE(BM_GetTopOfBook, Orderbook)->Arg(1)->Arg(5)->Arg(20);
+BENCHMARK_TEMPLATE(BM_GetTopOfBook, LadderOrderbook)->Arg(1)->Arg(5)->Arg(20);
+
+template <typename OrderbookType>
 static void BM_Size(benchmark::State& state)
 {
-    Orderbook orderbook;
+    OrderbookType orderbook;
     for (int i = 0; i < state.range(0); ++i)
     {
-        auto order = std::make_shared<Order>(
-            OrderType::GoodTillCancel, i, Side::Buy, 100, 10);
-        orderbook.AddOrder(order);
+        orderbook.AddOrder(OrderType::GoodTillCancel, i, Side::Buy, 50, 10);
     }
     
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
         benchmark::DoNotOptimize(orderbook.Size());
     }
 }
-BENCHMARK(BM_Size)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_Size, Orderbook)->RangeMultiplier(2)->Range(10, 1000);
+BENCHMARK_TEMPLATE(BM_Size, LadderOrderbook)->RangeMultiplier(2)->Range(10, 1000);
 
+template <typename OrderbookType>
 static void BM_MixedWorkload(benchmark::State& state)
 {
     // 60% add, 30% cancel, 10% query
     std::mt19937 rng(42);
     std::uniform_int_distribution<> op_dist(1, 10);
-    std::uniform_int_distribution<> price_dist(95, 105);
+    std::uniform_int_distribution<> price_dist(45, 55);
     
+    AllocationCounter allocations(state, state.range(0));
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
+        allocations.PauseTiming();
+        OrderbookType orderbook;
         uint64_t order_id = 0;
         std::vector<uint64_t> active_orders;
-        state.ResumeTiming();
+        allocations.ResumeTiming();
         
         for (int i = 0; i < state.range(0); ++i)
         {
@@ -233,14 +512,13 @@ static void BM_MixedWorkload(benchmark::State& state)
             
             if (op <= 6)
             {
-                auto order = std::make_shared<Order>(
+                orderbook.AddOrder(
                     OrderType::GoodTillCancel,
                     order_id,
                     order_id % 2 == 0 ? Side::Buy : Side::Sell,
                     price_dist(rng),
                     10
                 );
-                orderbook.AddOrder(order);
                 active_orders.push_back(order_id);
                 order_id++;
             }
@@ -257,27 +535,108 @@ static void BM_MixedWorkload(benchmark::State& state)
         }
     }
 }
-BENCHMARK(BM_MixedWorkload)->RangeMultiplier(2)->Range(100, 1000);
+BENCHMARK_TEMPLATE(BM_MixedWorkload, Orderbook)->RangeMultiplier(2)->Range(100, 1000);
+BENCHMARK_TEMPLATE(BM_MixedWorkload, LadderOrderbook)->RangeMultiplier(2)->Range(100, 1000);
+
+// A replayable command stream: mostly resting adds around the touch, with
+// cancels, modifies and occasional crossing orders.
+static std::vector<OrderbookCommand> MakeReplayCommands(int count)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<> op_dist(1, 10);
+    std::uniform_int_distribution<> price_dist(40, 60);
+    std::vector<OrderbookCommand> commands;
+    commands.reserve(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        int op = op_dist(rng);
+        OrderId orderId = static_cast<OrderId>(i);
+        Side side = i % 2 == 0 ? Side::Buy : Side::Sell;
+        Price price = side == Side::Buy ? price_dist(rng) - 10 : price_dist(rng) + 10;
+
+        if (op <= 7)
+            commands.push_back({ OrderbookCommand::Action::Add, OrderType::GoodTillCancel, orderId, side, price, 10 });
+        else if (op == 8)
+            commands.push_back({ OrderbookCommand::Action::Add, OrderType::FillAndKill, orderId, side, side == Side::Buy ? 99 : 1, 15 });
+        else if (op == 9 && i > 0)
+            commands.push_back({ OrderbookCommand::Action::Cancel, OrderType::GoodTillCancel, rng() % i, side, 0, 0 });
+        else
+            commands.push_back({ OrderbookCommand::Action::Modify, OrderType::GoodTillCancel, i > 0 ? rng() % i : 0, side, price, 5 });
+    }
+    return commands;
+}
+
+template <typename OrderbookType>
+static void BM_ReplayPerCall(benchmark::State& state)
+{
+    const auto commands = MakeReplayCommands(state.range(0));
+
+    AllocationCounter allocations(state, state.range(0));
+    for (auto _ : state)
+    {
+        allocations.PauseTiming();
+        auto orderbook = std::make_unique<OrderbookType>(state.range(0));
+        allocations.ResumeTiming();
+
+        for (const auto& command : commands)
+            benchmark::DoNotOptimize(orderbook->Apply(command));
+
+        allocations.PauseTiming();
+        orderbook.reset();
+        allocations.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ReplayPerCall, Orderbook)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE(BM_ReplayPerCall, LadderOrderbook)->RangeMultiplier(10)->Range(1000, 100000);
 
+template <typename OrderbookType>
+static void BM_ReplayApplyBatch(benchmark::State& state)
+{
+    const auto commands = MakeReplayCommands(state.range(0));
+    Trades trades;
+    trades.reserve(commands.size());
+
+    AllocationCounter allocations(state, state.range(0));
+    for (auto _ : state)
+    {
+        allocations.PauseTiming();
+        auto orderbook = std::make_unique<OrderbookType>(state.range(0));
+        allocations.ResumeTiming();
+
+        orderbook->ApplyBatch(commands, trades);
+        benchmark::DoNotOptimize(trades.data());
+
+        allocations.PauseTiming();
+        orderbook.reset();
+        allocations.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ReplayApplyBatch, Orderbook)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK_TEMPLATE(BM_ReplayApplyBatch, LadderOrderbook)->RangeMultiplier(10)->Range(1000, 100000);
+
+template <typename OrderbookType>
 static void BM_HighFrequencyTrading(benchmark::State& state)
 {
+    AllocationCounter allocations(state, state.range(0));
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
+        allocations.PauseTiming();
+        OrderbookType orderbook;
         uint64_t order_id = 0;
-        state.ResumeTiming();
+        allocations.ResumeTiming();
         
         for (int i = 0; i < state.range(0); ++i)
         {
-            auto order = std::make_shared<Order>(
+            orderbook.AddOrder(
                 OrderType::GoodTillCancel,
                 order_id,
                 i % 2 == 0 ? Side::Buy : Side::Sell,
-                100 + (i % 2 == 0 ? -1 : 1),
+                50 + (i % 2 == 0 ? -1 : 1),
                 10
             );
-            orderbook.AddOrder(order);
             
             // Immediately cancel 50% of orders
             if (i % 2 == 0 && i > 0)
@@ -288,84 +647,101 @@ static void BM_HighFrequencyTrading(benchmark::State& state)
         }
     }
 }
-BENCHMARK(BM_HighFrequencyTrading)->RangeMultiplier(2)->Range(100, 1000);
+BENCHMARK_TEMPLATE(BM_HighFrequencyTrading, Orderbook)->RangeMultiplier(2)->Range(100, 1000);
+BENCHMARK_TEMPLATE(BM_HighFrequencyTrading, LadderOrderbook)->RangeMultiplier(2)->Range(100, 1000);
 
+template <typename OrderbookType>
 static void BM_FillAndKillMatch(benchmark::State& state)
 {
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
+        allocations.PauseTiming();
+        OrderbookType orderbook;
 
-        auto resting = std::make_shared<Order>(
-            OrderType::GoodTillCancel, 1, Side::Buy, 100, 100);
-        orderbook.AddOrder(resting);
-        state.ResumeTiming();
+        orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 50, 100);
+        allocations.ResumeTiming();
         
-        auto fak = std::make_shared<Order>(
-            OrderType::FillAndKill, 2, Side::Sell, 100, 50);
-        benchmark::DoNotOptimize(orderbook.AddOrder(fak));
+        benchmark::DoNotOptimize(orderbook.AddOrder(OrderType::FillAndKill, 2, Side::Sell, 50, 50));
     }
 }
-BENCHMARK(BM_FillAndKillMatch);
+BENCHMARK_TEMPLATE(BM_FillAndKillMatch, Orderbook);
+BENCHMARK_TEMPLATE(BM_FillAndKillMatch, LadderOrderbook);
 
+template <typename OrderbookType>
 static void BM_FillAndKillNoMatch(benchmark::State& state)
 {
+    AllocationCounter allocations(state);
     for (auto _ : state)
     {
-        Orderbook orderbook;
+        OrderbookType orderbook;
 
-        auto fak = std::make_shared<Order>(
-            OrderType::FillAndKill, 1, Side::Buy, 100, 10);
-        benchmark::DoNotOptimize(orderbook.AddOrder(fak));
+        benchmark::DoNotOptimize(orderbook.AddOrder(OrderType::FillAndKill, 1, Side::Buy, 50, 10));
     }
 }
-BENCHMARK(BM_FillAndKillNoMatch);
+BENCHMARK_TEMPLATE(BM_FillAndKillNoMatch, Orderbook);
+BENCHMARK_TEMPLATE(BM_FillAndKillNoMatch, LadderOrderbook);
 
+template <typename OrderbookType>
 static void BM_DeepOrderBook(benchmark::State& state)
 {
+    AllocationCounter allocations(state, state.range(0));
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
-        state.ResumeTiming();
+        allocations.PauseTiming();
+        OrderbookType orderbook;
+        allocations.ResumeTiming();
         
         for (int i = 0; i < state.range(0); ++i)
         {
-            auto order = std::make_shared<Order>(
+            benchmark::DoNotOptimize(orderbook.AddOrder(
                 OrderType::GoodTillCancel,
                 i,
                 i % 2 == 0 ? Side::Buy : Side::Sell,
-                100 + i,
+                i % 2 == 0 ? 49 - i % 49 : 50 + i % 50,
                 10
-            );
-            benchmark::DoNotOptimize(orderbook.AddOrder(order));
+            ));
         }
     }
 }
-BENCHMARK(BM_DeepOrderBook)->RangeMultiplier(2)->Range(100, 1000);
+BENCHMARK_TEMPLATE(BM_DeepOrderBook, Orderbook)->RangeMultiplier(2)->Range(100, 1000);
+BENCHMARK_TEMPLATE(BM_DeepOrderBook, LadderOrderbook)->RangeMultiplier(2)->Range(100, 1000);
 
+template <typename OrderbookType>
 static void BM_WideOrderBook(benchmark::State& state)
 {
+    AllocationCounter allocations(state, state.range(0));
     for (auto _ : state)
     {
-        state.PauseTiming();
-        Orderbook orderbook;
-        state.ResumeTiming();
+        allocations.PauseTiming();
+        OrderbookType orderbook;
+        allocations.ResumeTiming();
         
         for (int i = 0; i < state.range(0); ++i)
         {
-            auto order = std::make_shared<Order>(
+            benchmark::DoNotOptimize(orderbook.AddOrder(
                 OrderType::GoodTillCancel,
                 i,
                 Side::Buy,
-                100,
+                50,
                 10
-            );
-            benchmark::DoNotOptimize(orderbook.AddOrder(order));
+            ));
         }
     }
 }
-BENCHMARK(BM_WideOrderBook)->RangeMultiplier(2)->Range(100, 1000);
+BENCHMARK_TEMPLATE(BM_WideOrderBook, Orderbook)->RangeMultiplier(2)->Range(100, 1000);
+BENCHMARK_TEMPLATE(BM_WideOrderBook, LadderOrderbook)->RangeMultiplier(2)->Range(100, 1000);
+
+// The cost one enabled MORNINGSIDE_PROBE adds to a hot-path call: two TSC
+// reads and a histogram increment in thread-local storage.
+static void BM_ScopedProbe(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        ScopedProbe probe{ LatencyProbe::AddOrder };
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ScopedProbe);
 
 BENCHMARK_MAIN();
\ No newline at end of file
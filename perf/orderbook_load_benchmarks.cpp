@@ -0,0 +1,319 @@
+#include "internal/Journal.h"
+#include "internal/LatencyHistogram.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+using Clock = std::chrono::steady_clock;
+
+// Share of each operation in a synthetic stream, in percent. Cross orders are
+// fill-and-kill orders priced through the touch; everything else rests.
+struct LoadMix
+{
+    const char* name_;
+    int add_;
+    int cancel_;
+    int modify_;
+    int cross_;
+};
+
+static constexpr std::array<LoadMix, 3> LoadMixes{ {
+    { "balanced", 45, 40, 10, 5 },
+    { "amend_heavy", 30, 25, 40, 5 },
+    { "aggressive", 40, 30, 5, 25 },
+} };
+
+static constexpr std::uint64_t LoadSeed = 20240601;
+static constexpr std::int64_t LoadOperations = 1 << 20;
+
+// Resting prices cluster at the touch: the distance from mid, in ticks, is
+// Zipf-distributed over 1..49, so bids rest at 50 - d and asks at 49 + d.
+class ZipfDistance
+{
+private:
+    static constexpr int MaxDistance = 49;
+    std::array<double, MaxDistance> cdf_{ };
+
+public:
+    explicit ZipfDistance(double exponent = 1.1)
+    {
+        double total = 0.0;
+        for (int distance = 1; distance <= MaxDistance; ++distance)
+        {
+            total += 1.0 / std::pow(distance, exponent);
+            cdf_[distance - 1] = total;
+        }
+        for (auto& probability : cdf_)
+            probability /= total;
+    }
+
+    template <typename Rng>
+    Price operator()(Rng& rng) const
+    {
+        double draw = std::uniform_real_distribution<>(0.0, 1.0)(rng);
+        auto it = std::lower_bound(cdf_.begin(), cdf_.end(), draw);
+        return static_cast<Price>(std::min<std::ptrdiff_t>(it - cdf_.begin(), MaxDistance - 1) + 1);
+    }
+};
+
+enum class LoadKind
+{
+    Add,
+    Cancel,
+    Modify,
+    Cross,
+};
+
+static constexpr std::array<const char*, 4> LoadKindNames{ "add", "cancel", "modify", "cross" };
+
+static LoadKind KindOf(const OrderbookCommand& command)
+{
+    switch (command.action_)
+    {
+    case OrderbookCommand::Action::Cancel:
+        return LoadKind::Cancel;
+    case OrderbookCommand::Action::Modify:
+        return LoadKind::Modify;
+    default:
+        return command.orderType_ == OrderType::GoodTillCancel || command.orderType_ == OrderType::PostOnly
+            ? LoadKind::Add
+            : LoadKind::Cross;
+    }
+}
+
+struct LiveOrder
+{
+    OrderId orderId_;
+    Side side_;
+    Price price_;
+    Quantity quantity_;
+};
+
+// Generates a reproducible stream against a book that already holds the
+// generator's live orders. Orders filled by a cross stay in the live set, so a
+// later cancel or modify of one is a no-op, as it would be for a late client.
+class LoadGenerator
+{
+private:
+    std::mt19937_64 rng_{ LoadSeed };
+    ZipfDistance distance_;
+    std::vector<LiveOrder> live_;
+    OrderId nextOrderId_{ 1 };
+
+    Side NextSide() { return rng_() & 1 ? Side::Buy : Side::Sell; }
+    Quantity NextQuantity() { return static_cast<Quantity>(1 + rng_() % 100); }
+
+    Price RestingPrice(Side side)
+    {
+        Price distance = distance_(rng_);
+        return side == Side::Buy ? 50 - distance : 49 + distance;
+    }
+
+public:
+    LiveOrder NextResting()
+    {
+        Side side = NextSide();
+        LiveOrder order{ nextOrderId_++, side, RestingPrice(side), NextQuantity() };
+        live_.push_back(order);
+        return order;
+    }
+
+    OrderbookCommand Next(const LoadMix& mix)
+    {
+        auto roll = static_cast<int>(rng_() % 100);
+        if (live_.empty() || roll < mix.add_)
+        {
+            auto order = NextResting();
+            return { OrderbookCommand::Action::Add, OrderType::GoodTillCancel, order.orderId_, order.side_, order.price_, order.quantity_ };
+        }
+
+        if (roll < mix.add_ + mix.cross_)
+        {
+            Side side = NextSide();
+            Price distance = distance_(rng_);
+            return { OrderbookCommand::Action::Add, OrderType::FillAndKill, nextOrderId_++, side,
+                side == Side::Buy ? 49 + distance : 50 - distance, NextQuantity() };
+        }
+
+        auto index = static_cast<std::size_t>(rng_() % live_.size());
+        LiveOrder& order = live_[index];
+        if (roll < mix.add_ + mix.cross_ + mix.cancel_)
+        {
+            OrderbookCommand command{ OrderbookCommand::Action::Cancel, OrderType::GoodTillCancel, order.orderId_, order.side_, order.price_, 0 };
+            order = live_.back();
+            live_.pop_back();
+            return command;
+        }
+
+        // Half of the amends shrink in place, half move to a new price.
+        if (rng_() & 1)
+            order.quantity_ = std::max<Quantity>(1, order.quantity_ / 2);
+        else
+            order.price_ = RestingPrice(order.side_);
+        return { OrderbookCommand::Action::Modify, OrderType::GoodTillCancel, order.orderId_, order.side_, order.price_, order.quantity_ };
+    }
+};
+
+static double PeakRssMegabytes()
+{
+    rusage usage{ };
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+}
+
+template <typename OrderbookType, typename Sink>
+static void Apply(OrderbookType& orderbook, const OrderbookCommand& command, Sink& onTrade)
+{
+    switch (command.action_)
+    {
+    case OrderbookCommand::Action::Add:
+        orderbook.AddOrder(command.orderType_, command.orderId_, command.side_, command.price_, command.quantity_, onTrade);
+        break;
+    case OrderbookCommand::Action::Cancel:
+        orderbook.CancelOrder(command.orderId_);
+        break;
+    case OrderbookCommand::Action::Modify:
+        orderbook.MatchOrder(OrderModify{ command.orderId_, command.side_, command.price_, command.quantity_ }, onTrade);
+        break;
+    }
+}
+
+// Reports the overall and per-operation latency distribution. The timer reads
+// around each operation are part of every sample, so compare runs against each
+// other rather than with the microbenchmarks.
+static void ReportLatencies(benchmark::State& state, const std::array<LatencyHistogram, 4>& histograms)
+{
+    LatencyHistogram overall;
+    for (std::size_t kind = 0; kind < histograms.size(); ++kind)
+    {
+        const auto& histogram = histograms[kind];
+        if (histogram.Count() == 0)
+            continue;
+
+        std::string name = LoadKindNames[kind];
+        state.counters[name + "_p50_ns"] = histogram.Percentile(0.50);
+        state.counters[name + "_p99_ns"] = histogram.Percentile(0.99);
+        state.counters[name + "_p99.9_ns"] = histogram.Percentile(0.999);
+        overall.Merge(histogram);
+    }
+    state.counters["p50_ns"] = overall.Percentile(0.50);
+    state.counters["p99_ns"] = overall.Percentile(0.99);
+    state.counters["p99.9_ns"] = overall.Percentile(0.999);
+    state.counters["max_ns"] = static_cast<double>(overall.Max());
+    // The process-wide high-water mark, so it includes every benchmark run before.
+    state.counters["peak_rss_mb"] = PeakRssMegabytes();
+}
+
+// Times a synthetic stream of state.range(0) resting orders and the mix
+// LoadMixes[state.range(1)]. Prefilling the book and generating the stream are
+// untimed; each iteration is one operation, timed individually.
+template <typename OrderbookType>
+static void BM_SyntheticLoad(benchmark::State& state)
+{
+    const auto restingOrders = static_cast<std::size_t>(state.range(0));
+    const LoadMix& mix = LoadMixes[static_cast<std::size_t>(state.range(1))];
+    state.SetLabel(mix.name_);
+
+    OrderbookType orderbook(restingOrders + static_cast<std::size_t>(LoadOperations));
+    std::uint64_t trades = 0;
+    auto onTrade = [&trades](const Trade&) { ++trades; };
+
+    LoadGenerator generator;
+    for (std::size_t i = 0; i < restingOrders; ++i)
+    {
+        auto order = generator.NextResting();
+        orderbook.AddOrder(OrderType::GoodTillCancel, order.orderId_, order.side_, order.price_, order.quantity_, onTrade);
+    }
+
+    std::vector<OrderbookCommand> commands;
+    commands.reserve(static_cast<std::size_t>(LoadOperations));
+    for (std::int64_t i = 0; i < LoadOperations; ++i)
+        commands.push_back(generator.Next(mix));
+
+    std::array<LatencyHistogram, 4> histograms;
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        const auto& command = commands[next++ % commands.size()];
+        auto start = Clock::now();
+        Apply(orderbook, command, onTrade);
+        auto end = Clock::now();
+        histograms[static_cast<std::size_t>(KindOf(command))].Record(
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["resting"] = static_cast<double>(orderbook.Size());
+    state.counters["trades"] = static_cast<double>(trades);
+    ReportLatencies(state, histograms);
+}
+
+// Every mix at 10^5 resting orders, then the balanced mix up to 10^7. Sizes
+// ascend so that peak_rss_mb tracks the largest book built so far.
+static void LoadArguments(benchmark::internal::Benchmark* benchmark)
+{
+    for (std::size_t mix = 0; mix < LoadMixes.size(); ++mix)
+        benchmark->Args({ 100'000, static_cast<std::int64_t>(mix) });
+    benchmark->Args({ 1'000'000, 0 });
+    benchmark->Args({ 10'000'000, 0 });
+    benchmark->Iterations(LoadOperations)->Unit(benchmark::kNanosecond);
+}
+BENCHMARK_TEMPLATE(BM_SyntheticLoad, Orderbook)->Apply(LoadArguments);
+BENCHMARK_TEMPLATE(BM_SyntheticLoad, LadderOrderbook)->Apply(LoadArguments);
+
+// Replays recorded order flow from the journal named by MORNINGSIDE_LOAD_JOURNAL
+// (as written by JournalWriter) into an empty book, timing each command.
+template <typename OrderbookType>
+static void BM_RecordedLoad(benchmark::State& state)
+{
+    const char* path = std::getenv("MORNINGSIDE_LOAD_JOURNAL");
+    if (path == nullptr)
+    {
+        state.SkipWithError("set MORNINGSIDE_LOAD_JOURNAL to a journal file");
+        return;
+    }
+
+    JournalReader reader(path);
+    std::vector<OrderbookCommand> commands;
+    for (const auto& record : reader.Records())
+    {
+        if (record.IsCommand())
+            commands.push_back(record.ToCommand());
+    }
+
+    std::array<LatencyHistogram, 4> histograms;
+    std::uint64_t trades = 0;
+    auto onTrade = [&trades](const Trade&) { ++trades; };
+    std::size_t resting = 0;
+    for (auto _ : state)
+    {
+        OrderbookType orderbook(commands.size());
+        for (const auto& command : commands)
+        {
+            auto start = Clock::now();
+            Apply(orderbook, command, onTrade);
+            auto end = Clock::now();
+            histograms[static_cast<std::size_t>(KindOf(command))].Record(
+                static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+        resting = orderbook.Size();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(commands.size()));
+    state.counters["resting"] = static_cast<double>(resting);
+    state.counters["trades"] = static_cast<double>(trades);
+    ReportLatencies(state, histograms);
+}
+BENCHMARK_TEMPLATE(BM_RecordedLoad, Orderbook)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_RecordedLoad, LadderOrderbook)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,88 @@
+#include "internal/OrderbookManager.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr std::size_t MarketCount = 256;
+constexpr std::size_t SubmitBatchSize = 256;
+
+// A mixed add/cancel stream spread uniformly over the markets. Every order it
+// adds is cancelled (or filled) by the end, so the stream can be replayed
+// against the same books on each iteration.
+static std::vector<MarketCommand> MakeCommandStream(std::size_t commandCount)
+{
+    std::mt19937_64 rng{ 42 };
+    std::uniform_int_distribution<MarketId> marketDist(0, MarketCount - 1);
+    std::uniform_int_distribution<int> actionDist(0, 9);
+    std::uniform_int_distribution<Price> priceDist(1, 60);
+    std::uniform_int_distribution<Quantity> quantityDist(1, 100);
+
+    std::vector<std::vector<OrderId>> live(MarketCount);
+    std::vector<OrderId> nextOrderId(MarketCount, 1);
+    std::vector<MarketCommand> commands;
+    commands.reserve(commandCount * 2);
+
+    for (std::size_t i = 0; i < commandCount; ++i)
+    {
+        auto marketId = marketDist(rng);
+        auto& orders = live[marketId];
+
+        if (orders.empty() || actionDist(rng) < 6)
+        {
+            auto side = actionDist(rng) < 5 ? Side::Buy : Side::Sell;
+            auto price = side == Side::Buy ? priceDist(rng) : 100 - priceDist(rng);
+            auto orderId = nextOrderId[marketId]++;
+            orders.push_back(orderId);
+            commands.push_back({ marketId, { OrderbookCommand::Action::Add, OrderType::GoodTillCancel,
+                orderId, side, price, quantityDist(rng) } });
+        }
+        else
+        {
+            auto index = std::uniform_int_distribution<std::size_t>(0, orders.size() - 1)(rng);
+            std::swap(orders[index], orders.back());
+            commands.push_back({ marketId, { OrderbookCommand::Action::Cancel, OrderType::GoodTillCancel,
+                orders.back(), Side::Buy, 0, 0 } });
+            orders.pop_back();
+        }
+    }
+
+    for (MarketId marketId = 0; marketId < MarketCount; ++marketId)
+    {
+        for (auto orderId : live[marketId])
+            commands.push_back({ marketId, { OrderbookCommand::Action::Cancel, OrderType::GoodTillCancel,
+                orderId, Side::Buy, 0, 0 } });
+    }
+    return commands;
+}
+
+template <typename ManagerType>
+static void BM_ShardedThroughput(benchmark::State& state)
+{
+    const auto commands = MakeCommandStream(1 << 18);
+
+    ManagerType manager(state.range(0));
+    for (std::size_t i = 0; i < MarketCount; ++i)
+        manager.AddMarket("MARKET-" + std::to_string(i), 1024);
+    manager.Start();
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < commands.size(); i += SubmitBatchSize)
+        {
+            auto count = std::min(SubmitBatchSize, commands.size() - i);
+            manager.Submit(std::span<const MarketCommand>{ commands.data() + i, count });
+        }
+        manager.Drain();
+    }
+
+    manager.Stop();
+    state.SetItemsProcessed(state.iterations() * commands.size());
+    state.counters["trades"] = benchmark::Counter(static_cast<double>(manager.TradeCount()), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_TEMPLATE(BM_ShardedThroughput, OrderbookManager)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ShardedThroughput, LadderOrderbookManager)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
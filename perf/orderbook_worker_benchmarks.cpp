@@ -0,0 +1,98 @@
+#include "internal/OrderbookWorker.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double Percentile(std::vector<std::int64_t>& samples, double percentile)
+{
+    if (samples.empty())
+        return 0.0;
+
+    auto index = static_cast<std::size_t>(percentile * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return static_cast<double>(samples[index]);
+}
+
+// Each round enqueues state.range(0) resting asks and the bids that cross them,
+// then waits for the trades. Latency is measured per trade, from the moment the
+// crossing bid was enqueued to the moment its trade was dequeued.
+template <typename WorkerType>
+static void BM_EnqueueToTradeLatency(benchmark::State& state)
+{
+    const auto inFlight = static_cast<std::size_t>(state.range(0));
+
+    WorkerType worker(1 << 16, 1024);
+    worker.Start(1);
+
+    std::vector<Clock::time_point> enqueuedAt(inFlight);
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(1 << 22);
+    OrderId nextOrderId = 1;
+
+    for (auto _ : state)
+    {
+        const OrderId firstBidId = nextOrderId + inFlight;
+        for (std::size_t i = 0; i < inFlight; ++i)
+        {
+            worker.Submit({ OrderbookCommand::Action::Add, OrderType::GoodTillCancel, nextOrderId + i, Side::Sell, 50, 10 });
+            enqueuedAt[i] = Clock::now();
+            worker.Submit({ OrderbookCommand::Action::Add, OrderType::GoodTillCancel, firstBidId + i, Side::Buy, 50, 10 });
+        }
+        nextOrderId += 2 * inFlight;
+
+        std::size_t received = 0;
+        while (received < inFlight)
+        {
+            received += worker.PollTrades([&](const Trade& trade)
+                {
+                    auto now = Clock::now();
+                    auto index = trade.GetBidTrade().orderId_ - firstBidId;
+                    if (latencies.size() < latencies.capacity())
+                        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - enqueuedAt[index]).count());
+                });
+        }
+    }
+
+    worker.Stop();
+    state.SetItemsProcessed(state.iterations() * inFlight);
+    state.counters["p50_ns"] = Percentile(latencies, 0.50);
+    state.counters["p99_ns"] = Percentile(latencies, 0.99);
+    state.counters["p99.9_ns"] = Percentile(latencies, 0.999);
+}
+BENCHMARK_TEMPLATE(BM_EnqueueToTradeLatency, OrderbookWorker)->Arg(1)->Arg(16)->Arg(256)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_EnqueueToTradeLatency, LadderOrderbookWorker)->Arg(1)->Arg(16)->Arg(256)->UseRealTime();
+
+// The same trades produced by calling the book directly on the caller's thread.
+template <typename WorkerType>
+static void BM_SynchronousAddToTradeLatency(benchmark::State& state)
+{
+    typename WorkerType::OrderbookType orderbook(1024);
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(1 << 22);
+    OrderId nextOrderId = 1;
+
+    for (auto _ : state)
+    {
+        orderbook.AddOrder(OrderType::GoodTillCancel, nextOrderId++, Side::Sell, 50, 10);
+        auto enqueuedAt = Clock::now();
+        auto trades = orderbook.AddOrder(OrderType::GoodTillCancel, nextOrderId++, Side::Buy, 50, 10);
+        auto now = Clock::now();
+        benchmark::DoNotOptimize(trades.data());
+        if (latencies.size() < latencies.capacity())
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - enqueuedAt).count());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["p50_ns"] = Percentile(latencies, 0.50);
+    state.counters["p99_ns"] = Percentile(latencies, 0.99);
+    state.counters["p99.9_ns"] = Percentile(latencies, 0.999);
+}
+BENCHMARK_TEMPLATE(BM_SynchronousAddToTradeLatency, OrderbookWorker);
+BENCHMARK_TEMPLATE(BM_SynchronousAddToTradeLatency, LadderOrderbookWorker);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,128 @@
+#include "internal/Snapshot.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+struct RestingOrder
+{
+    OrderId orderId_;
+    Side side_;
+    Price price_;
+    Quantity quantity_;
+};
+
+// Non-crossing resting orders spread over the 1-99 range.
+static std::vector<RestingOrder> MakeRestingOrders(std::size_t count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<Price> bidDist(1, 49);
+    std::uniform_int_distribution<Price> askDist(50, 99);
+    std::uniform_int_distribution<Quantity> quantityDist(1, 500);
+    std::vector<RestingOrder> orders;
+    orders.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Side side = i % 2 == 0 ? Side::Buy : Side::Sell;
+        orders.push_back({ i + 1, side, side == Side::Buy ? bidDist(rng) : askDist(rng), quantityDist(rng) });
+    }
+    return orders;
+}
+
+static std::string SnapshotPath(std::size_t index)
+{
+    return "/tmp/morningside_bench_" + std::to_string(index) + ".snapshot";
+}
+
+template <typename OrderbookType>
+static void BM_RebuildWithAddOrder(benchmark::State& state)
+{
+    const auto orders = MakeRestingOrders(state.range(0), 42);
+
+    for (auto _ : state)
+    {
+        auto orderbook = std::make_unique<OrderbookType>();
+        for (const auto& order : orders)
+            orderbook->AddOrder(OrderType::GoodTillCancel, order.orderId_, order.side_, order.price_, order.quantity_);
+        benchmark::DoNotOptimize(orderbook->Size());
+
+        state.PauseTiming();
+        orderbook.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * orders.size());
+}
+BENCHMARK_TEMPLATE(BM_RebuildWithAddOrder, Orderbook)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_RebuildWithAddOrder, LadderOrderbook)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+// Includes opening and mapping the file, as a cold start would.
+template <typename OrderbookType>
+static void BM_LoadSnapshot(benchmark::State& state)
+{
+    const auto path = SnapshotPath(0);
+    {
+        OrderbookType orderbook;
+        for (const auto& order : MakeRestingOrders(state.range(0), 42))
+            orderbook.AddOrder(OrderType::GoodTillCancel, order.orderId_, order.side_, order.price_, order.quantity_);
+        WriteSnapshot(orderbook, path);
+    }
+
+    for (auto _ : state)
+    {
+        auto orderbook = std::make_unique<OrderbookType>();
+        SnapshotReader snapshot(path);
+        LoadSnapshot(snapshot, *orderbook);
+        benchmark::DoNotOptimize(orderbook->Size());
+
+        state.PauseTiming();
+        orderbook.reset();
+        state.ResumeTiming();
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_LoadSnapshot, Orderbook)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LoadSnapshot, LadderOrderbook)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+// Warm start of state.range(0) markets with 500 resting orders each, one
+// snapshot file per market.
+template <typename OrderbookType>
+static void BM_WarmStartMarkets(benchmark::State& state)
+{
+    const auto markets = static_cast<std::size_t>(state.range(0));
+    for (std::size_t market = 0; market < markets; ++market)
+    {
+        OrderbookType orderbook;
+        for (const auto& order : MakeRestingOrders(500, static_cast<unsigned>(market)))
+            orderbook.AddOrder(OrderType::GoodTillCancel, order.orderId_, order.side_, order.price_, order.quantity_);
+        WriteSnapshot(orderbook, SnapshotPath(market));
+    }
+
+    for (auto _ : state)
+    {
+        std::vector<std::unique_ptr<OrderbookType>> orderbooks;
+        orderbooks.reserve(markets);
+        for (std::size_t market = 0; market < markets; ++market)
+        {
+            orderbooks.push_back(std::make_unique<OrderbookType>());
+            SnapshotReader snapshot(SnapshotPath(market));
+            LoadSnapshot(snapshot, *orderbooks.back());
+        }
+        benchmark::DoNotOptimize(orderbooks.data());
+
+        state.PauseTiming();
+        orderbooks.clear();
+        state.ResumeTiming();
+    }
+
+    for (std::size_t market = 0; market < markets; ++market)
+        std::remove(SnapshotPath(market).c_str());
+    state.SetItemsProcessed(state.iterations() * markets);
+}
+BENCHMARK_TEMPLATE(BM_WarmStartMarkets, LadderOrderbook)->Arg(100)->Arg(500)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
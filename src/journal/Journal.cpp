@@ -0,0 +1,215 @@
+#include "internal/Journal.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <format>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    [[noreturn]] void ThrowErrno(const char* what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+}
+
+JournalRecord JournalRecord::FromCommand(const OrderbookCommand& command)
+{
+    JournalRecord record{ };
+    switch (command.action_)
+    {
+    case OrderbookCommand::Action::Add: record.type_ = Type::Add; break;
+    case OrderbookCommand::Action::Cancel: record.type_ = Type::Cancel; break;
+    case OrderbookCommand::Action::Modify: record.type_ = Type::Modify; break;
+    }
+    record.orderType_ = static_cast<std::uint8_t>(command.orderType_);
+    record.side_ = static_cast<std::uint8_t>(command.side_);
+    record.price_ = command.price_;
+    record.quantity_ = command.quantity_;
+    record.orderId_ = command.orderId_;
+    return record;
+}
+
+JournalRecord JournalRecord::FromTrade(const Trade& trade)
+{
+    JournalRecord record{ };
+    record.type_ = Type::Trade;
+    record.price_ = trade.GetBidTrade().price_;
+    record.quantity_ = trade.GetBidTrade().quantity_;
+    record.counterPrice_ = trade.GetAskTrade().price_;
+    record.orderId_ = trade.GetBidTrade().orderId_;
+    record.counterOrderId_ = trade.GetAskTrade().orderId_;
+    return record;
+}
+
+OrderbookCommand JournalRecord::ToCommand() const
+{
+    OrderbookCommand::Action action;
+    switch (type_)
+    {
+    case Type::Add: action = OrderbookCommand::Action::Add; break;
+    case Type::Cancel: action = OrderbookCommand::Action::Cancel; break;
+    case Type::Modify: action = OrderbookCommand::Action::Modify; break;
+    default: throw std::runtime_error("journal record is not a command");
+    }
+
+    return { action, static_cast<OrderType>(orderType_), orderId_, static_cast<Side>(side_), price_, quantity_ };
+}
+
+Trade JournalRecord::ToTrade() const
+{
+    return Trade{
+        TradeInfo{ orderId_, price_, quantity_ },
+        TradeInfo{ counterOrderId_, counterPrice_, quantity_ }
+    };
+}
+
+JournalWriter::JournalWriter(const std::string& path, JournalSync sync, std::size_t bufferRecords)
+    : sync_{ sync }
+{
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+        ThrowErrno("cannot open journal");
+
+    struct stat status;
+    if (::fstat(fd_, &status) != 0)
+    {
+        ::close(fd_);
+        ThrowErrno("cannot stat journal");
+    }
+
+    if (status.st_size == 0)
+    {
+        JournalHeader header{ JournalHeader::Magic, JournalHeader::CurrentVersion, sizeof(JournalRecord), { } };
+        WriteAll(fd_, &header, sizeof(header), "journal write failed");
+    }
+    else
+    {
+        JournalHeader header{ };
+        if (static_cast<std::size_t>(status.st_size) < sizeof(header))
+        {
+            ::close(fd_);
+            throw std::runtime_error("journal is missing its header");
+        }
+        if (::pread(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        {
+            ::close(fd_);
+            ThrowErrno("cannot read journal header");
+        }
+        if (header.magic_ != JournalHeader::Magic || header.version_ != JournalHeader::CurrentVersion ||
+            header.recordSize_ != sizeof(JournalRecord))
+        {
+            ::close(fd_);
+            throw std::runtime_error("unsupported journal format");
+        }
+
+        // A crash mid-write can leave a partial record at the end. Drop it so
+        // appended records stay aligned with the reader's view of the file.
+        auto count = (static_cast<std::size_t>(status.st_size) - sizeof(header)) / sizeof(JournalRecord);
+        if (::ftruncate(fd_, static_cast<off_t>(sizeof(header) + count * sizeof(JournalRecord))) != 0)
+        {
+            ::close(fd_);
+            ThrowErrno("cannot truncate journal");
+        }
+    }
+
+    buffer_.reserve(std::max<std::size_t>(bufferRecords, 1));
+}
+
+JournalWriter::~JournalWriter()
+{
+    try
+    {
+        Flush();
+    }
+    catch (const std::exception&)
+    {
+    }
+    ::close(fd_);
+}
+
+void JournalWriter::WriteBuffer()
+{
+    if (buffer_.empty())
+        return;
+
+    WriteAll(fd_, buffer_.data(), buffer_.size() * sizeof(JournalRecord), "journal write failed");
+    buffer_.clear();
+}
+
+void JournalWriter::Flush()
+{
+    WriteBuffer();
+    if (sync_ != JournalSync::None && ::fsync(fd_) != 0)
+        ThrowErrno("journal fsync failed");
+}
+
+void JournalWriter::Sync()
+{
+    WriteBuffer();
+    if (::fsync(fd_) != 0)
+        ThrowErrno("journal fsync failed");
+}
+
+JournalReader::JournalReader(const std::string& path)
+    : file_{ path }
+{
+    if (file_.Size() < sizeof(JournalHeader))
+        throw std::runtime_error("journal is missing its header");
+
+    auto header = reinterpret_cast<const JournalHeader*>(file_.Data());
+    if (header->magic_ != JournalHeader::Magic || header->version_ != JournalHeader::CurrentVersion ||
+        header->recordSize_ != sizeof(JournalRecord))
+        throw std::runtime_error("unsupported journal format");
+
+    auto count = (file_.Size() - sizeof(JournalHeader)) / sizeof(JournalRecord);
+    records_ = { reinterpret_cast<const JournalRecord*>(header + 1), count };
+}
+
+template <typename Levels>
+JournalReplayStats ReplayJournal(std::span<const JournalRecord> records, BasicOrderbook<Levels>& orderbook)
+{
+    constexpr std::size_t BatchSize = 256;
+
+    JournalReplayStats stats;
+    std::array<OrderbookCommand, BatchSize> batch;
+    std::size_t count = 0;
+    auto onTrade = [&stats](const Trade&) { ++stats.replayedTrades_; };
+
+    for (const auto& record : records)
+    {
+        if (record.IsTrade())
+        {
+            ++stats.recordedTrades_;
+            continue;
+        }
+        if (!record.IsCommand())
+        {
+            orderbook.ApplyBatch(std::span<const OrderbookCommand>{ batch.data(), count }, onTrade);
+            stats.commands_ += count;
+            throw std::runtime_error(std::format("unknown journal record type {} at record {}",
+                static_cast<unsigned>(record.type_), &record - records.data()));
+        }
+
+        batch[count++] = record.ToCommand();
+        if (count == BatchSize)
+        {
+            orderbook.ApplyBatch(batch, onTrade);
+            stats.commands_ += count;
+            count = 0;
+        }
+    }
+
+    orderbook.ApplyBatch(std::span<const OrderbookCommand>{ batch.data(), count }, onTrade);
+    stats.commands_ += count;
+    return stats;
+}
+
+template JournalReplayStats ReplayJournal(std::span<const JournalRecord>, BasicOrderbook<MapLevels>&);
+template JournalReplayStats ReplayJournal(std::span<const JournalRecord>, BasicOrderbook<ArrayLevels<>>&);
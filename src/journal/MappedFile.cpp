@@ -0,0 +1,62 @@
+#include "internal/MappedFile.h"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+        auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "cannot stat " + path);
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ > 0)
+    {
+        data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data_ == MAP_FAILED)
+        {
+            auto error = errno;
+            data_ = nullptr;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "cannot map " + path);
+        }
+        ::madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(data_, size_);
+}
+
+void WriteAll(int fd, const void* data, std::size_t size, const char* what)
+{
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        auto written = ::write(fd, bytes, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
@@ -0,0 +1,109 @@
+#include "internal/Snapshot.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+template <typename Levels>
+void WriteSnapshot(const BasicOrderbook<Levels>& orderbook, const std::string& path, std::uint64_t journalPosition)
+{
+    constexpr std::size_t BufferSize = 4096;
+
+    const std::string temporaryPath = path + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "cannot create " + temporaryPath);
+
+    try
+    {
+        SnapshotHeader header{ SnapshotHeader::Magic, SnapshotHeader::CurrentVersion,
+            sizeof(SnapshotOrder), orderbook.Size(), journalPosition };
+        WriteAll(fd, &header, sizeof(header), "snapshot write failed");
+
+        std::vector<SnapshotOrder> buffer;
+        buffer.reserve(BufferSize);
+        orderbook.ForEachOrder([&](const Order& order)
+            {
+                buffer.push_back(SnapshotOrder{
+                    order.GetOrderId(),
+                    order.GetPrice(),
+                    order.GetInitialQuantity(),
+                    order.GetRemainingQuantity(),
+                    static_cast<std::uint8_t>(order.GetOrderType()),
+                    static_cast<std::uint8_t>(order.GetSide()),
+                    0
+                });
+                if (buffer.size() == BufferSize)
+                {
+                    WriteAll(fd, buffer.data(), buffer.size() * sizeof(SnapshotOrder), "snapshot write failed");
+                    buffer.clear();
+                }
+            });
+        WriteAll(fd, buffer.data(), buffer.size() * sizeof(SnapshotOrder), "snapshot write failed");
+
+        if (::fsync(fd) != 0)
+            throw std::system_error(errno, std::generic_category(), "snapshot fsync failed");
+    }
+    catch (...)
+    {
+        ::close(fd);
+        std::remove(temporaryPath.c_str());
+        throw;
+    }
+
+    ::close(fd);
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        throw std::system_error(errno, std::generic_category(), "cannot rename snapshot to " + path);
+}
+
+SnapshotReader::SnapshotReader(const std::string& path)
+    : file_{ path }
+{
+    if (file_.Size() < sizeof(SnapshotHeader))
+        throw std::runtime_error("snapshot is missing its header");
+
+    header_ = reinterpret_cast<const SnapshotHeader*>(file_.Data());
+    if (header_->magic_ != SnapshotHeader::Magic || header_->version_ != SnapshotHeader::CurrentVersion ||
+        header_->orderSize_ != sizeof(SnapshotOrder))
+        throw std::runtime_error("unsupported snapshot format");
+
+    if (file_.Size() != sizeof(SnapshotHeader) + header_->orderCount_ * sizeof(SnapshotOrder))
+        throw std::runtime_error("snapshot is truncated");
+
+    orders_ = { reinterpret_cast<const SnapshotOrder*>(header_ + 1), static_cast<std::size_t>(header_->orderCount_) };
+}
+
+template <typename Levels>
+void LoadSnapshot(const SnapshotReader& snapshot, BasicOrderbook<Levels>& orderbook)
+{
+    if (orderbook.Size() != 0)
+        throw std::logic_error("A snapshot can only be loaded into an empty orderbook.");
+
+    // Decoded in full before the book is touched, so a bad record leaves it empty.
+    std::vector<Order> orders;
+    orders.reserve(snapshot.Orders().size());
+    for (const auto& order : snapshot.Orders())
+    {
+        if (order.orderType_ > static_cast<std::uint8_t>(OrderType::Market) ||
+            order.side_ > static_cast<std::uint8_t>(Side::Sell) ||
+            order.remainingQuantity_ == 0 || order.remainingQuantity_ > order.initialQuantity_)
+            throw std::runtime_error("snapshot contains an invalid or duplicate order");
+
+        orders.emplace_back(static_cast<OrderType>(order.orderType_), order.orderId_,
+            static_cast<Side>(order.side_), order.price_, order.initialQuantity_);
+        orders.back().Fill(order.initialQuantity_ - order.remainingQuantity_);
+    }
+
+    if (!orderbook.RestoreOrders(orders))
+        throw std::runtime_error("snapshot contains an invalid or duplicate order");
+}
+
+template void WriteSnapshot(const BasicOrderbook<MapLevels>&, const std::string&, std::uint64_t);
+template void WriteSnapshot(const BasicOrderbook<ArrayLevels<>>&, const std::string&, std::uint64_t);
+template void LoadSnapshot(const SnapshotReader&, BasicOrderbook<MapLevels>&);
+template void LoadSnapshot(const SnapshotReader&, BasicOrderbook<ArrayLevels<>>&);
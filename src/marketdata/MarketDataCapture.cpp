@@ -0,0 +1,88 @@
+#include "internal/MarketDataCapture.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+MarketDataCaptureWriter::MarketDataCaptureWriter(const std::string& path)
+    : fd_(-1)
+    , recordCount_(0) {
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot create capture " + path);
+    }
+
+    CaptureHeader header{CaptureHeader::Magic, CaptureHeader::CurrentVersion, sizeof(CaptureRecordHeader), {}};
+    try {
+        WriteAll(fd_, &header, sizeof(header), "capture write failed");
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+}
+
+MarketDataCaptureWriter::~MarketDataCaptureWriter() {
+    ::close(fd_);
+}
+
+void MarketDataCaptureWriter::append(std::string_view ticker, long responseCode, std::string_view body) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    append(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), ticker, responseCode, body);
+}
+
+void MarketDataCaptureWriter::append(std::int64_t timestampNanoseconds, std::string_view ticker, long responseCode, std::string_view body) {
+    CaptureRecordHeader record{
+        timestampNanoseconds,
+        responseCode,
+        static_cast<std::uint32_t>(ticker.size()),
+        static_cast<std::uint32_t>(body.size())
+    };
+
+    buffer_.clear();
+    buffer_.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    buffer_.append(ticker);
+    buffer_.append(body);
+    WriteAll(fd_, buffer_.data(), buffer_.size(), "capture write failed");
+    ++recordCount_;
+}
+
+MarketDataCaptureReader::MarketDataCaptureReader(const std::string& path)
+    : file_(path) {
+    if (file_.Size() < sizeof(CaptureHeader)) {
+        throw std::runtime_error("capture is missing its header");
+    }
+
+    CaptureHeader header;
+    std::memcpy(&header, file_.Data(), sizeof(header));
+    if (header.magic != CaptureHeader::Magic || header.version != CaptureHeader::CurrentVersion ||
+        header.recordHeaderSize != sizeof(CaptureRecordHeader)) {
+        throw std::runtime_error("unsupported capture format");
+    }
+
+    const char* position = reinterpret_cast<const char*>(file_.Data()) + sizeof(CaptureHeader);
+    const char* end = reinterpret_cast<const char*>(file_.Data()) + file_.Size();
+
+    while (static_cast<std::size_t>(end - position) >= sizeof(CaptureRecordHeader)) {
+        CaptureRecordHeader record;
+        std::memcpy(&record, position, sizeof(record));
+
+        std::size_t payloadSize = std::size_t{record.tickerSize} + record.bodySize;
+        if (static_cast<std::size_t>(end - position) - sizeof(record) < payloadSize) {
+            break;
+        }
+
+        const char* ticker = position + sizeof(record);
+        responses_.push_back({
+            record.timestampNanoseconds,
+            static_cast<long>(record.responseCode),
+            std::string_view(ticker, record.tickerSize),
+            std::string_view(ticker + record.tickerSize, record.bodySize)
+        });
+        position = ticker + payloadSize;
+    }
+}
@@ -1,10 +1,23 @@
 #include "internal/MarketDataFeedHandler.h"
+#include "internal/Probes.h"
+#include "internal/KalshiAdapter.h"
+#include "internal/OrderbookJsonParser.h"
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <poll.h>
 
 MarketDataFeedHandler::MarketDataFeedHandler()
     : curl_(nullptr)
-    , baseUrl_("https://api.elections.kalshi.com/trade-api/v2/markets/")
+    , multi_(nullptr)
+    , maxConcurrentRequests_(16)
+    , replaySpeed_(ReplaySpeed::Maximum)
+    , streamCurl_(nullptr)
+    , streamHeaderList_(nullptr)
+    , streamUrl_("wss://api.elections.kalshi.com/trade-api/ws/v2")
+    , nextCommandId_(1)
+    , adapter_(std::make_unique<KalshiAdapter>())
+    , baseUrl_(adapter_->defaultEndpoint())
     , timeout_(30)
     , userAgent_("Kalshi-Orderbook-Client/1.0")
     , initialized_(false) {
@@ -44,6 +57,9 @@ bool MarketDataFeedHandler::initialize() {
 }
 
 void MarketDataFeedHandler::cleanup() {
+    disconnectStream();
+    cleanupBatch();
+
     if (curl_) {
         curl_easy_cleanup(curl_);
         curl_ = nullptr;
@@ -55,43 +71,102 @@ void MarketDataFeedHandler::cleanup() {
     }
 }
 
-json MarketDataFeedHandler::fetchOrderbookData(const std::string& ticker) {
+std::string_view MarketDataFeedHandler::fetchOrderbookBody(const std::string& ticker) {
+    MORNINGSIDE_PROBE(FeedFetch);
+
+    if (replay_) {
+        const CapturedResponse* captured = nextReplayResponse(ticker);
+        if (!captured) {
+            throw std::runtime_error(lastError_);
+        }
+        response_.responseCode = captured->responseCode;
+        if (captured->responseCode != 200) {
+            throw std::runtime_error("HTTP request failed with code: " + std::to_string(captured->responseCode));
+        }
+        return captured->body;
+    }
+
     if (!initialized_ && !initialize()) {
         throw std::runtime_error("Failed to initialize MarketDataFeedHandler: " + lastError_);
     }
 
-    std::string url = buildOrderbookUrl(ticker);
-    APIResponse response;
-    
-    if (!performHttpRequest(url, response)) {
+    if (!performHttpRequest(buildOrderbookUrl(ticker), response_)) {
         throw std::runtime_error("HTTP request failed: " + lastError_);
     }
 
-    if (response.responseCode != 200) {
-        throw std::runtime_error("HTTP request failed with code: " + std::to_string(response.responseCode));
+    captureResponse(ticker, response_);
+
+    if (response_.responseCode != 200) {
+        throw std::runtime_error("HTTP request failed with code: " + std::to_string(response_.responseCode));
     }
 
+    return response_.data;
+}
+
+json MarketDataFeedHandler::fetchOrderbookData(const std::string& ticker) {
+    std::string_view body = fetchOrderbookBody(ticker);
+
     try {
-        return json::parse(response.data);
+        return json::parse(body);
     } catch (const json::parse_error& e) {
         throw std::runtime_error("Failed to parse JSON response: " + std::string(e.what()));
     }
 }
 
+template <typename Handler>
+bool MarketDataFeedHandler::parseOrderbookBody(std::string_view body, Handler&& handler) {
+    const char* error = nullptr;
+    if (!OrderbookJsonParser::parse(body, handler, error)) {
+        lastError_ = error;
+        return false;
+    }
+
+    lastError_.clear();
+    return true;
+}
+
+template <typename Handler>
+bool MarketDataFeedHandler::parseOrderbookLevels(const std::string& ticker, Handler&& handler) {
+    try {
+        return parseOrderbookBody(fetchOrderbookBody(ticker), handler);
+    } catch (const std::exception& e) {
+        lastError_ = std::string(e.what());
+        return false;
+    }
+}
+
+template <typename OrderbookType>
+bool MarketDataFeedHandler::decodeOrderbookBody(std::string_view body, OrderbookType& orderbook) {
+    MORNINGSIDE_PROBE(FeedDecode);
+
+    const char* error = nullptr;
+    if (!adapter_->decodeOrderbook(body, orderbook, error)) {
+        lastError_ = error;
+        return false;
+    }
+
+    lastError_.clear();
+    return true;
+}
+
 bool MarketDataFeedHandler::populateOrderbook(Orderbook& orderbook, const std::string& ticker) {
+    MORNINGSIDE_PROBE(FeedPopulate);
+
     try {
-        json marketData = fetchOrderbookData(ticker);
-        
-        if (!marketData.contains("orderbook")) {
-            lastError_ = "Invalid response: missing orderbook data";
-            return false;
-        }
+        return decodeOrderbookBody(fetchOrderbookBody(ticker), orderbook);
+    } catch (const std::exception& e) {
+        lastError_ = std::string(e.what());
+        return false;
+    }
+}
 
-        json orderbookData = marketData["orderbook"];
-        OrderId currentOrderId = 1;
-        
-        return parseAndAddOrders(orderbookData, orderbook, currentOrderId);
-        
+bool MarketDataFeedHandler::populateOrderbook(LevelOrderbook& orderbook, const std::string& ticker) {
+    MORNINGSIDE_PROBE(FeedPopulate);
+
+    orderbook.Clear();
+
+    try {
+        return decodeOrderbookBody(fetchOrderbookBody(ticker), orderbook);
     } catch (const std::exception& e) {
         lastError_ = std::string(e.what());
         return false;
@@ -100,18 +175,10 @@ bool MarketDataFeedHandler::populateOrderbook(Orderbook& orderbook, const std::s
 
 bool MarketDataFeedHandler::getOrderbookLevelInfos(const std::string& ticker, OrderbookLevelInfos& levelInfos) {
     try {
-        json marketData = fetchOrderbookData(ticker);
-        
-        if (!marketData.contains("orderbook")) {
-            lastError_ = "Invalid response: missing orderbook data";
-            return false;
-        }
+        LevelOrderbook orderbook;
 
-        json orderbookData = marketData["orderbook"];
-        LevelInfos bids, asks;
-        
-        if (parseIntoLevelInfos(orderbookData, bids, asks)) {
-            levelInfos = OrderbookLevelInfos(bids, asks);
+        if (populateOrderbook(orderbook, ticker)) {
+            levelInfos = orderbook.GetOrderInfos();
             return true;
         }
         
@@ -123,10 +190,516 @@ bool MarketDataFeedHandler::getOrderbookLevelInfos(const std::string& ticker, Or
     }
 }
 
+std::size_t MarketDataFeedHandler::fetchOrderbooks(std::span<const std::string> tickers, const OrderbookResponseCallback& onResponse) {
+    if (replay_) {
+        return replayOrderbooks(tickers, onResponse);
+    }
+
+    if (!initializeBatch()) {
+        return 0;
+    }
+
+    std::size_t nextTicker = 0;
+    std::size_t succeeded = 0;
+    int running = 0;
+
+    for (auto& transfer : batchTransfers_) {
+        if (nextTicker == tickers.size()) {
+            break;
+        }
+        startBatchTransfer(transfer, nextTicker, tickers[nextTicker]);
+        ++nextTicker;
+        ++running;
+    }
+
+    while (running > 0) {
+        int stillRunning = 0;
+        CURLMcode code = curl_multi_perform(multi_, &stillRunning);
+        if (code != CURLM_OK) {
+            lastError_ = "Curl multi failed: " + std::string(curl_multi_strerror(code));
+            cleanupBatch();
+            return succeeded;
+        }
+
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi_, &queued)) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            // The message is invalid once its handle is removed, so read it first.
+            CURLcode result = message->data.result;
+            BatchTransfer* transfer = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+            curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &transfer->response.responseCode);
+            curl_multi_remove_handle(multi_, transfer->curl);
+            --running;
+
+            if (result != CURLE_OK) {
+                transfer->response.error = "Curl request failed: " + std::string(curl_easy_strerror(result));
+            } else if (transfer->response.responseCode != 200) {
+                transfer->response.error = "HTTP request failed with code: " + std::to_string(transfer->response.responseCode);
+            } else {
+                ++succeeded;
+            }
+
+            if (result == CURLE_OK) {
+                captureResponse(tickers[transfer->tickerIndex], transfer->response);
+            }
+
+            onResponse(tickers[transfer->tickerIndex], transfer->response);
+
+            if (nextTicker < tickers.size()) {
+                startBatchTransfer(*transfer, nextTicker, tickers[nextTicker]);
+                ++nextTicker;
+                ++running;
+            }
+        }
+
+        if (running > 0 && stillRunning > 0) {
+            code = curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+            if (code != CURLM_OK) {
+                lastError_ = "Curl multi failed: " + std::string(curl_multi_strerror(code));
+                cleanupBatch();
+                return succeeded;
+            }
+        }
+    }
+
+    return succeeded;
+}
+
+std::size_t MarketDataFeedHandler::populateOrderbooks(std::span<const std::string> tickers, std::span<LevelOrderbook* const> orderbooks) {
+    if (orderbooks.size() < tickers.size()) {
+        lastError_ = "populateOrderbooks needs one orderbook per ticker";
+        return 0;
+    }
+
+    std::size_t populated = 0;
+    std::string firstError;
+
+    fetchOrderbooks(tickers, [&](const std::string& ticker, const APIResponse& response) {
+        LevelOrderbook& orderbook = *orderbooks[&ticker - tickers.data()];
+        orderbook.Clear();
+
+        bool parsed = response.error.empty() && decodeOrderbookBody(response.data, orderbook);
+
+        if (parsed) {
+            ++populated;
+        } else if (firstError.empty()) {
+            firstError = ticker + ": " + (response.error.empty() ? lastError_ : response.error);
+        }
+    });
+
+    lastError_ = firstError;
+    return populated;
+}
+
+bool MarketDataFeedHandler::initializeBatch() {
+    if (!initialized_ && !initialize()) {
+        return false;
+    }
+
+    if (!multi_) {
+        multi_ = curl_multi_init();
+        if (!multi_) {
+            lastError_ = "Failed to initialize curl multi handle";
+            return false;
+        }
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>(maxConcurrentRequests_));
+    }
+
+    while (batchTransfers_.size() < maxConcurrentRequests_) {
+        CURL* curl = curl_easy_init();
+        if (!curl) {
+            lastError_ = "Failed to initialize curl handle";
+            return !batchTransfers_.empty();
+        }
+        batchTransfers_.emplace_back().curl = curl;
+    }
+
+    return true;
+}
+
+void MarketDataFeedHandler::cleanupBatch() {
+    for (auto& transfer : batchTransfers_) {
+        if (multi_) {
+            curl_multi_remove_handle(multi_, transfer.curl);
+        }
+        curl_easy_cleanup(transfer.curl);
+    }
+    batchTransfers_.clear();
+
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+        multi_ = nullptr;
+    }
+}
+
+bool MarketDataFeedHandler::startCapture(const std::string& path) {
+    try {
+        capture_ = std::make_unique<MarketDataCaptureWriter>(path);
+    } catch (const std::exception& e) {
+        capture_.reset();
+        lastError_ = "Failed to start capture: " + std::string(e.what());
+        return false;
+    }
+    return true;
+}
+
+void MarketDataFeedHandler::stopCapture() {
+    capture_.reset();
+}
+
+bool MarketDataFeedHandler::isCapturing() const {
+    return capture_ != nullptr;
+}
+
+bool MarketDataFeedHandler::startReplay(const std::string& path, ReplaySpeed speed) {
+    stopReplay();
+
+    try {
+        replay_ = std::make_unique<MarketDataCaptureReader>(path);
+    } catch (const std::exception& e) {
+        lastError_ = "Failed to start replay: " + std::string(e.what());
+        return false;
+    }
+
+    for (const auto& response : replay_->responses()) {
+        replayCursors_[response.ticker].responses.push_back(&response);
+    }
+
+    replaySpeed_ = speed;
+    rewindReplay();
+    return true;
+}
+
+void MarketDataFeedHandler::rewindReplay() {
+    for (auto& [ticker, cursor] : replayCursors_) {
+        cursor.next = 0;
+    }
+    replayStart_ = std::chrono::steady_clock::now();
+}
+
+void MarketDataFeedHandler::stopReplay() {
+    replayCursors_.clear();
+    replay_.reset();
+}
+
+bool MarketDataFeedHandler::isReplaying() const {
+    return replay_ != nullptr;
+}
+
+void MarketDataFeedHandler::captureResponse(const std::string& ticker, const APIResponse& response) {
+    if (!capture_) {
+        return;
+    }
+
+    try {
+        capture_->append(ticker, response.responseCode, response.data);
+    } catch (const std::exception& e) {
+        capture_.reset();
+        lastError_ = "Capture stopped: " + std::string(e.what());
+    }
+}
+
+const CapturedResponse* MarketDataFeedHandler::nextReplayResponse(const std::string& ticker) {
+    auto it = replayCursors_.find(ticker);
+    if (it == replayCursors_.end() || it->second.next == it->second.responses.size()) {
+        lastError_ = "No captured response left for " + ticker;
+        return nullptr;
+    }
+
+    const CapturedResponse* response = it->second.responses[it->second.next++];
+    if (replaySpeed_ == ReplaySpeed::Recorded) {
+        auto offset = std::chrono::nanoseconds(response->timestampNanoseconds - replay_->responses().front().timestampNanoseconds);
+        std::this_thread::sleep_until(replayStart_ + offset);
+    }
+    return response;
+}
+
+std::size_t MarketDataFeedHandler::replayOrderbooks(std::span<const std::string> tickers, const OrderbookResponseCallback& onResponse) {
+    std::size_t succeeded = 0;
+
+    for (const auto& ticker : tickers) {
+        response_.data.clear();
+        response_.error.clear();
+        response_.responseCode = 0;
+
+        if (const CapturedResponse* captured = nextReplayResponse(ticker)) {
+            response_.data.assign(captured->body);
+            response_.responseCode = captured->responseCode;
+            if (captured->responseCode != 200) {
+                response_.error = "HTTP request failed with code: " + std::to_string(captured->responseCode);
+            } else {
+                ++succeeded;
+            }
+        } else {
+            response_.error = lastError_;
+        }
+
+        onResponse(ticker, response_);
+    }
+
+    return succeeded;
+}
+
+void MarketDataFeedHandler::startBatchTransfer(BatchTransfer& transfer, std::size_t tickerIndex, const std::string& ticker) {
+    transfer.tickerIndex = tickerIndex;
+    adapter_->buildOrderbookUrl(transfer.url, baseUrl_, ticker);
+    transfer.response.data.clear();
+    transfer.response.error.clear();
+    transfer.response.responseCode = 0;
+
+    curl_easy_setopt(transfer.curl, CURLOPT_URL, transfer.url.c_str());
+    curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, &transfer);
+    curl_easy_setopt(transfer.curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(transfer.curl, CURLOPT_WRITEDATA, &transfer.response);
+    curl_easy_setopt(transfer.curl, CURLOPT_TIMEOUT, timeout_);
+    curl_easy_setopt(transfer.curl, CURLOPT_USERAGENT, userAgent_.c_str());
+    curl_easy_setopt(transfer.curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(transfer.curl, CURLOPT_SSL_VERIFYPEER, 1L);
+    curl_easy_setopt(transfer.curl, CURLOPT_SSL_VERIFYHOST, 2L);
+    curl_easy_setopt(transfer.curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(transfer.curl, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(transfer.curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+    curl_multi_add_handle(multi_, transfer.curl);
+}
+
+bool MarketDataFeedHandler::connectStream() {
+    if (streamCurl_) {
+        return true;
+    }
+
+    if (!initialized_ && !initialize()) {
+        return false;
+    }
+
+    streamCurl_ = curl_easy_init();
+    if (!streamCurl_) {
+        lastError_ = "Failed to initialize stream curl handle";
+        return false;
+    }
+
+    for (const auto& header : streamHeaders_) {
+        streamHeaderList_ = curl_slist_append(streamHeaderList_, header.c_str());
+    }
+
+    curl_easy_setopt(streamCurl_, CURLOPT_URL, streamUrl_.c_str());
+    curl_easy_setopt(streamCurl_, CURLOPT_CONNECT_ONLY, 2L);
+    curl_easy_setopt(streamCurl_, CURLOPT_CONNECTTIMEOUT, timeout_);
+    curl_easy_setopt(streamCurl_, CURLOPT_USERAGENT, userAgent_.c_str());
+    curl_easy_setopt(streamCurl_, CURLOPT_HTTPHEADER, streamHeaderList_);
+
+    CURLcode result = curl_easy_perform(streamCurl_);
+    if (result != CURLE_OK) {
+        lastError_ = "WebSocket connect failed: " + std::string(curl_easy_strerror(result));
+        disconnectStream();
+        return false;
+    }
+
+    lastError_.clear();
+    return true;
+}
+
+void MarketDataFeedHandler::disconnectStream() {
+    if (streamCurl_) {
+        curl_easy_cleanup(streamCurl_);
+        streamCurl_ = nullptr;
+    }
+
+    if (streamHeaderList_) {
+        curl_slist_free_all(streamHeaderList_);
+        streamHeaderList_ = nullptr;
+    }
+
+    streamBuffer_.clear();
+    for (auto& [ticker, subscription] : subscriptions_) {
+        subscription.synced = false;
+    }
+}
+
+bool MarketDataFeedHandler::isStreamConnected() const {
+    return streamCurl_ != nullptr;
+}
+
+bool MarketDataFeedHandler::subscribeOrderbook(const std::string& ticker, Orderbook& orderbook) {
+    if (!connectStream()) {
+        return false;
+    }
+
+    attachOrderbook(ticker, orderbook);
+    return sendSubscribeCommand(ticker);
+}
+
+bool MarketDataFeedHandler::subscribeOrderbook(const std::string& ticker, LevelOrderbook& orderbook) {
+    if (!connectStream()) {
+        return false;
+    }
+
+    attachOrderbook(ticker, orderbook);
+    return sendSubscribeCommand(ticker);
+}
+
+void MarketDataFeedHandler::attachOrderbook(const std::string& ticker, Orderbook& orderbook) {
+    auto& subscription = subscriptions_[ticker];
+    subscription = StreamSubscription();
+    subscription.orderbook = &orderbook;
+}
+
+void MarketDataFeedHandler::attachOrderbook(const std::string& ticker, LevelOrderbook& orderbook) {
+    auto& subscription = subscriptions_[ticker];
+    subscription = StreamSubscription();
+    subscription.levelOrderbook = &orderbook;
+}
+
+bool MarketDataFeedHandler::pollStream(int timeoutMilliseconds) {
+    if (!streamCurl_) {
+        lastError_ = "Stream not connected";
+        return false;
+    }
+
+    curl_socket_t socket = CURL_SOCKET_BAD;
+    curl_easy_getinfo(streamCurl_, CURLINFO_ACTIVESOCKET, &socket);
+    if (socket == CURL_SOCKET_BAD) {
+        lastError_ = "Stream socket unavailable";
+        disconnectStream();
+        return false;
+    }
+
+    pollfd descriptor{socket, POLLIN, 0};
+    if (::poll(&descriptor, 1, timeoutMilliseconds) <= 0) {
+        return true;
+    }
+
+    char buffer[16384];
+    while (true) {
+        size_t received = 0;
+#if LIBCURL_VERSION_NUM >= 0x080000
+        const curl_ws_frame* meta = nullptr;
+#else
+        curl_ws_frame* meta = nullptr;
+#endif
+        CURLcode result = curl_ws_recv(streamCurl_, buffer, sizeof(buffer), &received, &meta);
+
+        if (result == CURLE_AGAIN) {
+            return true;
+        }
+
+        if (result != CURLE_OK) {
+            lastError_ = "WebSocket receive failed: " + std::string(curl_easy_strerror(result));
+            disconnectStream();
+            return false;
+        }
+
+        if (meta->flags & CURLWS_CLOSE) {
+            lastError_ = "WebSocket closed by server";
+            disconnectStream();
+            return false;
+        }
+
+        if (!(meta->flags & (CURLWS_TEXT | CURLWS_CONT))) {
+            continue;
+        }
+
+        streamBuffer_.append(buffer, received);
+        if (meta->bytesleft == 0 && !(meta->flags & CURLWS_CONT)) {
+            handleStreamMessage(streamBuffer_);
+            streamBuffer_.clear();
+        }
+    }
+}
+
+bool MarketDataFeedHandler::handleStreamMessage(const std::string& message) {
+    try {
+        json envelope = json::parse(message);
+        const std::string type = envelope.value("type", "");
+
+        if (type == "error") {
+            lastError_ = "Stream error: " + envelope["msg"].dump();
+            return false;
+        }
+
+        if (type == "subscribed") {
+            int commandId = envelope.value("id", 0);
+            for (auto& [ticker, subscription] : subscriptions_) {
+                if (subscription.commandId == commandId) {
+                    subscription.sid = envelope.at("msg").value("sid", std::uint64_t{0});
+                }
+            }
+            return true;
+        }
+
+        if (type != "orderbook_snapshot" && type != "orderbook_delta") {
+            return true;
+        }
+
+        const json& body = envelope.at("msg");
+        const std::string ticker = body.at("market_ticker");
+        auto it = subscriptions_.find(ticker);
+        if (it == subscriptions_.end()) {
+            return true;
+        }
+
+        auto& subscription = it->second;
+        std::uint64_t sid = envelope.value("sid", std::uint64_t{0});
+        if (subscription.sid != 0 && sid != 0 && sid != subscription.sid) {
+            // Left over from a subscription that has since been replaced.
+            return true;
+        }
+
+        std::uint64_t seq = envelope.value("seq", std::uint64_t{0});
+
+        if (type == "orderbook_snapshot") {
+            subscription.lastSeq = seq;
+            subscription.synced = true;
+            return applyStreamSnapshot(subscription, body);
+        }
+
+        if (!subscription.synced) {
+            return true;
+        }
+
+        if (seq != subscription.lastSeq + 1) {
+            return requestStreamSnapshot(ticker, subscription);
+        }
+
+        subscription.lastSeq = seq;
+        if (!applyStreamDelta(subscription, body)) {
+            return requestStreamSnapshot(ticker, subscription);
+        }
+        return true;
+
+    } catch (const std::exception& e) {
+        lastError_ = "Error handling stream message: " + std::string(e.what());
+        return false;
+    }
+}
+
+const StreamSubscription* MarketDataFeedHandler::findStreamSubscription(const std::string& ticker) const {
+    auto it = subscriptions_.find(ticker);
+    return it == subscriptions_.end() ? nullptr : &it->second;
+}
+
+void MarketDataFeedHandler::setExchangeAdapter(std::unique_ptr<ExchangeAdapter> adapter) {
+    adapter_ = std::move(adapter);
+    baseUrl_ = adapter_->defaultEndpoint();
+}
+
 void MarketDataFeedHandler::setApiEndpoint(const std::string& endpoint) {
     baseUrl_ = endpoint;
 }
 
+void MarketDataFeedHandler::setStreamEndpoint(const std::string& endpoint) {
+    streamUrl_ = endpoint;
+}
+
+void MarketDataFeedHandler::addStreamHeader(const std::string& header) {
+    streamHeaders_.push_back(header);
+}
+
 void MarketDataFeedHandler::setTimeout(long timeoutSeconds) {
     timeout_ = timeoutSeconds;
     if (curl_) {
@@ -134,6 +707,11 @@ void MarketDataFeedHandler::setTimeout(long timeoutSeconds) {
     }
 }
 
+void MarketDataFeedHandler::setMaxConcurrentRequests(std::size_t maxConcurrentRequests) {
+    maxConcurrentRequests_ = maxConcurrentRequests > 0 ? maxConcurrentRequests : 1;
+    cleanupBatch();
+}
+
 void MarketDataFeedHandler::setUserAgent(const std::string& userAgent) {
     userAgent_ = userAgent;
     if (curl_) {
@@ -182,90 +760,142 @@ bool MarketDataFeedHandler::performHttpRequest(const std::string& url, APIRespon
     return true;
 }
 
-std::string MarketDataFeedHandler::buildOrderbookUrl(const std::string& ticker) const {
-    return baseUrl_ + ticker + "/orderbook";
+const std::string& MarketDataFeedHandler::buildOrderbookUrl(const std::string& ticker) {
+    adapter_->buildOrderbookUrl(url_, baseUrl_, ticker);
+    return url_;
 }
 
-bool MarketDataFeedHandler::parseAndAddOrders(const json& orderbookData, Orderbook& orderbook, OrderId& currentOrderId) {
-    try {
-        if (orderbookData.contains("yes")) {
-            for (const auto& level : orderbookData["yes"]) {
-                if (level.size() >= 2) {
-                    Price price = level[0];
-                    Quantity quantity = level[1];
-                    
-                    auto order = std::make_shared<Order>(
-                        OrderType::GoodTillCancel,
-                        currentOrderId++,
-                        Side::Buy,
-                        price,
-                        quantity
-                    );
-                    orderbook.AddOrder(order);
-                }
+bool MarketDataFeedHandler::sendSubscribeCommand(const std::string& ticker) {
+    int commandId = nextCommandId_++;
+    subscriptions_[ticker].commandId = commandId;
+
+    json command = {
+        {"id", commandId},
+        {"cmd", "subscribe"},
+        {"params", {
+            {"channels", {"orderbook_delta"}},
+            {"market_tickers", {ticker}}
+        }}
+    };
+
+    return sendStreamMessage(command.dump());
+}
+
+bool MarketDataFeedHandler::sendStreamMessage(const std::string& message) {
+    size_t sent = 0;
+    CURLcode result = curl_ws_send(streamCurl_, message.data(), message.size(), &sent, 0, CURLWS_TEXT);
+    if (result != CURLE_OK || sent != message.size()) {
+        lastError_ = "WebSocket send failed: " + std::string(curl_easy_strerror(result));
+        return false;
+    }
+    return true;
+}
+
+bool MarketDataFeedHandler::applyStreamSnapshot(StreamSubscription& subscription, const json& orderbookData) {
+    std::array<Quantity, KalshiMaxPrice + 1> yes{}, no{};
+
+    if (orderbookData.contains("yes") && orderbookData["yes"].is_array()) {
+        for (const auto& level : orderbookData["yes"]) {
+            Price price = level.at(0);
+            if (price >= KalshiMinPrice && price <= KalshiMaxPrice) {
+                yes[price] = level.at(1);
             }
         }
-        
-        if (orderbookData.contains("no")) {
-            for (const auto& level : orderbookData["no"]) {
-                if (level.size() >= 2) {
-                    Price noPrice = level[0];
-                    Quantity quantity = level[1];
-                    
-                    Price yesPrice = 100 - noPrice;
-                    
-                    auto order = std::make_shared<Order>(
-                        OrderType::GoodTillCancel,
-                        currentOrderId++,
-                        Side::Sell,
-                        yesPrice,
-                        quantity
-                    );
-                    orderbook.AddOrder(order);
-                }
+    }
+
+    if (orderbookData.contains("no") && orderbookData["no"].is_array()) {
+        for (const auto& level : orderbookData["no"]) {
+            Price price = level.at(0);
+            if (price >= KalshiMinPrice && price <= KalshiMaxPrice) {
+                no[price] = level.at(1);
             }
         }
-        
-        lastError_.clear();
-        return true;
-        
-    } catch (const std::exception& e) {
-        lastError_ = "Error parsing orderbook data: " + std::string(e.what());
-        return false;
     }
+
+    applyStreamLevels(subscription, yes, no);
+    lastError_.clear();
+    return true;
 }
 
-bool MarketDataFeedHandler::parseIntoLevelInfos(const json& orderbookData, LevelInfos& bids, LevelInfos& asks) {
-    try {
-        bids.clear();
-        asks.clear();
-        
-        if (orderbookData.contains("yes")) {
-            for (const auto& level : orderbookData["yes"]) {
-                if (level.size() >= 2) {
-                    Price price = level[0];
-                    Quantity quantity = level[1];
-                    bids.push_back({price, quantity});
-                }
+void MarketDataFeedHandler::applyStreamLevels(StreamSubscription& subscription,
+                                              const std::array<Quantity, KalshiMaxPrice + 1>& yes,
+                                              const std::array<Quantity, KalshiMaxPrice + 1>& no) {
+    // Levels that shrink go first, so the book only ever holds a subset of the
+    // old levels or of the new ones. A new yes level never meets a stale no
+    // level it would cross.
+    for (bool growing : {false, true}) {
+        for (Price price = KalshiMinPrice; price <= KalshiMaxPrice; ++price) {
+            if (yes[price] != subscription.yes[price] && (yes[price] > subscription.yes[price]) == growing) {
+                setStreamLevel(subscription, true, price, yes[price]);
             }
-        }
-        
-        if (orderbookData.contains("no")) {
-            for (const auto& level : orderbookData["no"]) {
-                if (level.size() >= 2) {
-                    Price noPrice = level[0];
-                    Quantity quantity = level[1];
-                    Price yesPrice = 100 - noPrice;
-                    asks.push_back({yesPrice, quantity});
-                }
+            if (no[price] != subscription.no[price] && (no[price] > subscription.no[price]) == growing) {
+                setStreamLevel(subscription, false, price, no[price]);
             }
         }
-        
-        lastError_.clear();
-        return true;
-        
-    } catch (const std::exception& e) {
-        lastError_ = "Error parsing level infos: " + std::string(e.what());
+    }
+}
+
+bool MarketDataFeedHandler::applyStreamDelta(StreamSubscription& subscription, const json& delta) {
+    Price price = delta.at("price");
+    long long change = delta.at("delta");
+    bool yes = delta.at("side") == "yes";
+
+    if (price < KalshiMinPrice || price > KalshiMaxPrice) {
+        lastError_ = "Stream delta price out of range: " + std::to_string(price);
         return false;
     }
+
+    long long quantity = static_cast<long long>(yes ? subscription.yes[price] : subscription.no[price]) + change;
+    if (quantity < 0) {
+        lastError_ = "Stream delta drove level below zero at price " + std::to_string(price);
+        return false;
+    }
+
+    setStreamLevel(subscription, yes, price, static_cast<Quantity>(quantity));
+    return true;
+}
+
+// A REST book carries no sequence number, so there is no telling which of the
+// deltas that follow it are already included. Instead the subscription is
+// replaced: the venue opens the new one with an orderbook_snapshot, and deltas
+// are ignored until it arrives.
+bool MarketDataFeedHandler::requestStreamSnapshot(const std::string& ticker, StreamSubscription& subscription) {
+    subscription.synced = false;
+
+    if (subscription.sid != 0) {
+        json command = {
+            {"id", nextCommandId_++},
+            {"cmd", "unsubscribe"},
+            {"params", {
+                {"sids", {subscription.sid}}
+            }}
+        };
+
+        subscription.sid = 0;
+        if (!sendStreamMessage(command.dump())) {
+            return false;
+        }
+    }
+
+    return sendSubscribeCommand(ticker);
+}
+
+void MarketDataFeedHandler::setStreamLevel(StreamSubscription& subscription, bool yes, Price price, Quantity quantity) {
+    // Yes bids rest as buys at their price, no bids as sells at the complementary yes price.
+    Side side = yes ? Side::Buy : Side::Sell;
+    Price bookPrice = yes ? price : 100 - price;
+
+    if (subscription.levelOrderbook) {
+        subscription.levelOrderbook->SetLevel(side, bookPrice, quantity);
+    } else {
+        OrderId orderId = yes ? price : KalshiMaxPrice + 1 + price;
+        // Restored rather than added, so a level is never run through matching
+        // and the book always holds exactly what the venue reported.
+        subscription.orderbook->CancelOrder(orderId);
+        if (quantity > 0) {
+            subscription.orderbook->RestoreOrder(OrderType::GoodTillCancel, orderId, side, bookPrice, quantity, quantity);
+        }
+    }
+
+    (yes ? subscription.yes : subscription.no)[price] = quantity;
 }
\ No newline at end of file
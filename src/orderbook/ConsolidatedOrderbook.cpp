@@ -0,0 +1,138 @@
+#include "internal/ConsolidatedOrderbook.h"
+
+#include <algorithm>
+
+namespace
+{
+    template <typename Ladder>
+    void AdjustLevel(Ladder& ladder, Price price, Quantity previous, Quantity quantity)
+    {
+        auto& level = ladder[price];
+        level.quantity_ = level.quantity_ - previous + quantity;
+        if (level.quantity_ == 0)
+            ladder.Erase(price);
+    }
+}
+
+ConsolidatedOrderbook::ConsolidatedOrderbook() { }
+
+ConsolidatedOrderbook::~ConsolidatedOrderbook() { }
+
+ConsolidatedOrderbook::SourceId ConsolidatedOrderbook::AddSource(bool complement)
+{
+    auto& source = sources_.emplace_back(std::make_unique<Source>());
+    source->complement_ = complement;
+    return sources_.size() - 1;
+}
+
+std::size_t ConsolidatedOrderbook::SourceCount() const
+{
+    return sources_.size();
+}
+
+void ConsolidatedOrderbook::Adjust(bool complement, Side side, Price price, Quantity previous, Quantity quantity)
+{
+    if (previous == quantity)
+        return;
+
+    if (complement)
+    {
+        side = side == Side::Buy ? Side::Sell : Side::Buy;
+        price = 100 - price;
+    }
+
+    if (side == Side::Buy)
+        AdjustLevel(bids_, price, previous, quantity);
+    else
+        AdjustLevel(asks_, price, previous, quantity);
+}
+
+bool ConsolidatedOrderbook::SetLevel(SourceId sourceId, Side side, Price price, Quantity quantity)
+{
+    auto& source = *sources_.at(sourceId);
+    Quantity previous = source.levels_.GetLevel(side, price);
+    if (!source.levels_.SetLevel(side, price, quantity))
+        return false;
+
+    Adjust(source.complement_, side, price, previous, quantity);
+    return true;
+}
+
+void ConsolidatedOrderbook::ClearSource(SourceId sourceId)
+{
+    auto& source = *sources_.at(sourceId);
+    for (Price price = KalshiMinPrice; price <= KalshiMaxPrice; ++price)
+    {
+        Adjust(source.complement_, Side::Buy, price, source.levels_.GetLevel(Side::Buy, price), 0);
+        Adjust(source.complement_, Side::Sell, price, source.levels_.GetLevel(Side::Sell, price), 0);
+    }
+    source.levels_.Clear();
+}
+
+void ConsolidatedOrderbook::ReplaceSource(SourceId sourceId, const LevelOrderbook& orderbook)
+{
+    auto& source = *sources_.at(sourceId);
+    for (Price price = KalshiMinPrice; price <= KalshiMaxPrice; ++price)
+    {
+        for (Side side : { Side::Buy, Side::Sell })
+        {
+            Quantity previous = source.levels_.GetLevel(side, price);
+            Quantity quantity = orderbook.GetLevel(side, price);
+            if (previous == quantity)
+                continue;
+
+            source.levels_.SetLevel(side, price, quantity);
+            Adjust(source.complement_, side, price, previous, quantity);
+        }
+    }
+}
+
+Quantity ConsolidatedOrderbook::GetLevel(Side side, Price price) const
+{
+    const Level* level = side == Side::Buy ? bids_.Find(price) : asks_.Find(price);
+    return level ? level->quantity_ : 0;
+}
+
+Quantity ConsolidatedOrderbook::GetSourceLevel(SourceId sourceId, Side side, Price price) const
+{
+    return sources_.at(sourceId)->levels_.GetLevel(side, price);
+}
+
+std::optional<LevelInfo> ConsolidatedOrderbook::GetBestBid() const
+{
+    if (bids_.Empty())
+        return std::nullopt;
+    return LevelInfo{ bids_.BestPrice(), bids_.Best().quantity_ };
+}
+
+std::optional<LevelInfo> ConsolidatedOrderbook::GetBestAsk() const
+{
+    if (asks_.Empty())
+        return std::nullopt;
+    return LevelInfo{ asks_.BestPrice(), asks_.Best().quantity_ };
+}
+
+bool ConsolidatedOrderbook::IsCrossed() const
+{
+    return !bids_.Empty() && !asks_.Empty() && bids_.BestPrice() >= asks_.BestPrice();
+}
+
+std::size_t ConsolidatedOrderbook::Size() const
+{
+    return bids_.Size() + asks_.Size();
+}
+
+OrderbookLevelInfos ConsolidatedOrderbook::GetTopOfBook(std::size_t depth) const
+{
+    LevelInfos bidInfos, askInfos;
+    bidInfos.reserve(std::min(depth, bids_.Size()));
+    askInfos.reserve(std::min(depth, asks_.Size()));
+
+    bids_.ForEach([&](Price price, const Level& level)
+        { bidInfos.push_back(LevelInfo{ price, level.quantity_ }); }, depth);
+
+    asks_.ForEach([&](Price price, const Level& level)
+        { askInfos.push_back(LevelInfo{ price, level.quantity_ }); }, depth);
+
+    return OrderbookLevelInfos{ std::move(bidInfos), std::move(askInfos) };
+}
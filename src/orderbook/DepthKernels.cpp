@@ -0,0 +1,224 @@
+#include "internal/DepthKernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+// Continues a sweep one level at a time from offset. Backward walks start at the
+// last element.
+template <bool Backward>
+QuantitySweep SweepScalar(std::span<const Quantity> quantities, std::uint64_t quantity,
+    std::size_t offset = 0, QuantitySweep sweep = { })
+{
+    auto count = quantities.size();
+    for (; offset < count && sweep.quantity_ < quantity; ++offset)
+    {
+        std::uint64_t available = quantities[Backward ? count - 1 - offset : offset];
+        if (available == 0)
+            continue;
+
+        auto taken = std::min(available, quantity - sweep.quantity_);
+        sweep.quantity_ += taken;
+        sweep.weightedOffset_ += offset * taken;
+        sweep.lastOffset_ = offset;
+    }
+    return sweep;
+}
+
+// Continues a running total from offset, writing each partial sum back at the
+// index it was read from.
+template <bool Backward>
+void ScanScalar(std::span<const Quantity> quantities, std::uint64_t* sums, std::uint64_t total,
+    std::size_t offset = 0)
+{
+    auto count = quantities.size();
+    for (; offset < count; ++offset)
+    {
+        auto index = Backward ? count - 1 - offset : offset;
+        total += quantities[index];
+        sums[index] = total;
+    }
+}
+
+std::uint64_t SumScalar(std::span<const Quantity> quantities)
+{
+    std::uint64_t total = 0;
+    for (auto quantity : quantities)
+        total += quantity;
+    return total;
+}
+
+#if defined(__x86_64__)
+
+// Four quantities widened to 64-bit lanes in walk order. A backward block is
+// read from its lowest address and reversed.
+template <bool Backward>
+[[gnu::target("avx2")]] __m256i LoadBlock(const Quantity* quantities)
+{
+    __m128i narrow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(quantities));
+    if constexpr (Backward)
+        narrow = _mm_shuffle_epi32(narrow, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm256_cvtepu32_epi64(narrow);
+}
+
+template <bool Backward>
+[[gnu::target("avx2")]] const Quantity* BlockAt(std::span<const Quantity> quantities, std::size_t offset)
+{
+    return quantities.data() + (Backward ? quantities.size() - 4 - offset : offset);
+}
+
+// Running total across the four lanes.
+[[gnu::target("avx2")]] __m256i ScanLanes(__m256i values)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    values = _mm256_add_epi64(values,
+        _mm256_blend_epi32(_mm256_permute4x64_epi64(values, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    values = _mm256_add_epi64(values,
+        _mm256_blend_epi32(_mm256_permute4x64_epi64(values, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+    return values;
+}
+
+[[gnu::target("avx2")]] __m256i BroadcastLast(__m256i values)
+{
+    return _mm256_permute4x64_epi64(values, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+[[gnu::target("avx2")]] std::uint64_t FirstLane(__m256i values)
+{
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm256_castsi256_si128(values)));
+}
+
+[[gnu::target("avx2")]] std::uint64_t AddLanes(__m256i values)
+{
+    __m128i pairs = _mm_add_epi64(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_add_epi64(pairs, _mm_unpackhi_epi64(pairs, pairs))));
+}
+
+// Eight quantities per step, split into two accumulators of 64-bit lanes. The
+// order the lanes are summed in does not matter, so the split needs no shuffle.
+[[gnu::target("avx2")]] std::uint64_t SumAvx2(std::span<const Quantity> quantities)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i low = zero;
+    __m256i high = zero;
+    std::size_t index = 0;
+    for (; index + 8 <= quantities.size(); index += 8)
+    {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(quantities.data() + index));
+        low = _mm256_add_epi64(low, _mm256_unpacklo_epi32(values, zero));
+        high = _mm256_add_epi64(high, _mm256_unpackhi_epi32(values, zero));
+    }
+
+    std::uint64_t total = AddLanes(_mm256_add_epi64(low, high));
+    for (; index < quantities.size(); ++index)
+        total += quantities[index];
+    return total;
+}
+
+template <bool Backward>
+[[gnu::target("avx2")]] void ScanAvx2(std::span<const Quantity> quantities, std::uint64_t* sums, std::uint64_t total)
+{
+    __m256i carry = _mm256_set1_epi64x(static_cast<long long>(total));
+    std::size_t offset = 0;
+    for (; offset + 4 <= quantities.size(); offset += 4)
+    {
+        auto* block = BlockAt<Backward>(quantities, offset);
+        __m256i partials = ScanLanes(LoadBlock<Backward>(block));
+        __m256i totals = _mm256_add_epi64(partials, carry);
+        carry = _mm256_add_epi64(carry, BroadcastLast(partials));
+        if constexpr (Backward)
+            totals = _mm256_permute4x64_epi64(totals, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + (block - quantities.data())), totals);
+    }
+    ScanScalar<Backward>(quantities, sums, FirstLane(carry), offset);
+}
+
+// Whole blocks are taken four levels at a time while the running total stays
+// short of quantity. The block that reaches it is finished one level at a time.
+// A walk from the best level often ends on it, so that case skips the setup.
+template <bool Backward>
+[[gnu::target("avx2")]] QuantitySweep SweepAvx2(std::span<const Quantity> quantities, std::uint64_t quantity)
+{
+    if (quantity == 0 || quantities.empty())
+        return { };
+    if ((Backward ? quantities.back() : quantities.front()) >= quantity)
+        return QuantitySweep{ quantity, 0, 0 };
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i limit = _mm256_set1_epi64x(static_cast<long long>(
+        std::min<std::uint64_t>(quantity - 1, std::numeric_limits<long long>::max())));
+    __m256i offsets = _mm256_setr_epi64x(0, 1, 2, 3);
+    __m256i carry = zero;
+    __m256i weighted = zero;
+    std::size_t lastOffset = 0;
+    std::size_t offset = 0;
+    for (; offset + 4 <= quantities.size(); offset += 4)
+    {
+        __m256i values = LoadBlock<Backward>(BlockAt<Backward>(quantities, offset));
+        __m256i partials = ScanLanes(values);
+        __m256i totals = _mm256_add_epi64(partials, carry);
+        __m256i reached = _mm256_cmpgt_epi64(totals, limit);
+        if (!_mm256_testz_si256(reached, reached))
+            break;
+
+        weighted = _mm256_add_epi64(weighted, _mm256_mul_epu32(values, offsets));
+        auto empty = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(values, zero))));
+        if (auto taken = ~empty & 0xF)
+            lastOffset = offset + std::bit_width(taken) - 1;
+        offsets = _mm256_add_epi64(offsets, _mm256_set1_epi64x(4));
+        carry = _mm256_add_epi64(carry, BroadcastLast(partials));
+    }
+
+    QuantitySweep sweep{ FirstLane(carry), AddLanes(weighted), lastOffset };
+    return SweepScalar<Backward>(quantities, quantity, offset, sweep);
+}
+
+#endif
+
+}
+
+const DepthKernels& DepthKernels::Scalar()
+{
+    static constexpr DepthKernels kernels{
+        SumScalar,
+        [](std::span<const Quantity> quantities, std::uint64_t* sums, std::uint64_t total)
+            { ScanScalar<false>(quantities, sums, total); },
+        [](std::span<const Quantity> quantities, std::uint64_t* sums, std::uint64_t total)
+            { ScanScalar<true>(quantities, sums, total); },
+        [](std::span<const Quantity> quantities, std::uint64_t quantity)
+            { return SweepScalar<false>(quantities, quantity); },
+        [](std::span<const Quantity> quantities, std::uint64_t quantity)
+            { return SweepScalar<true>(quantities, quantity); },
+    };
+    return kernels;
+}
+
+const DepthKernels* DepthKernels::Avx2()
+{
+#if defined(__x86_64__)
+    static constexpr DepthKernels kernels{
+        SumAvx2,
+        ScanAvx2<false>,
+        ScanAvx2<true>,
+        SweepAvx2<false>,
+        SweepAvx2<true>,
+    };
+    return __builtin_cpu_supports("avx2") ? &kernels : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const DepthKernels& DepthKernels::Best()
+{
+    static const DepthKernels& kernels = Avx2() ? *Avx2() : Scalar();
+    return kernels;
+}
@@ -0,0 +1,158 @@
+#include "internal/Instrumentation.h"
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace
+{
+    struct MetricsRegistry
+    {
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<ThreadMetrics>> threads_;
+    };
+
+    MetricsRegistry& Registry()
+    {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    double MeasureTicksPerNanosecond()
+    {
+        using Clock = std::chrono::steady_clock;
+
+        auto startTime = Clock::now();
+        auto startTicks = ReadTicks();
+        while (Clock::now() - startTime < std::chrono::milliseconds(10)) { }
+        auto endTicks = ReadTicks();
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count();
+        return static_cast<double>(endTicks - startTicks) / static_cast<double>(elapsed);
+    }
+}
+
+std::string_view ToString(LatencyProbe probe)
+{
+    switch (probe)
+    {
+    case LatencyProbe::AddOrder: return "add_order";
+    case LatencyProbe::CancelOrder: return "cancel_order";
+    case LatencyProbe::ModifyOrder: return "modify_order";
+    case LatencyProbe::MatchOrders: return "match_orders";
+    case LatencyProbe::FeedFetch: return "feed_fetch";
+    case LatencyProbe::FeedDecode: return "feed_decode";
+    case LatencyProbe::FeedPopulate: return "feed_populate";
+    case LatencyProbe::Count: break;
+    }
+    return "unknown";
+}
+
+std::string_view ToString(EventCounter counter)
+{
+    switch (counter)
+    {
+    case EventCounter::OrdersAdded: return "orders_added";
+    case EventCounter::OrdersRejected: return "orders_rejected";
+    case EventCounter::OrdersCancelled: return "orders_cancelled";
+    case EventCounter::OrdersModified: return "orders_modified";
+    case EventCounter::LevelsCreated: return "levels_created";
+    case EventCounter::LevelsErased: return "levels_erased";
+    case EventCounter::Trades: return "trades";
+    case EventCounter::FillAndKillCancels: return "fill_and_kill_cancels";
+    case EventCounter::Count: break;
+    }
+    return "unknown";
+}
+
+double TicksPerNanosecond()
+{
+    static const double ticksPerNanosecond = MeasureTicksPerNanosecond();
+    return ticksPerNanosecond;
+}
+
+ThreadMetrics& LocalMetrics()
+{
+    thread_local ThreadMetrics* metrics = nullptr;
+    if (!metrics)
+    {
+        auto& registry = Registry();
+        std::lock_guard lock{ registry.mutex_ };
+        metrics = registry.threads_.emplace_back(std::make_unique<ThreadMetrics>()).get();
+    }
+    return *metrics;
+}
+
+void MetricsSnapshot::Collect(const ThreadMetrics& metrics)
+{
+    for (std::size_t probe = 0; probe < LatencyProbeCount; ++probe)
+    {
+        for (std::size_t bucket = 0; bucket < LatencyHistogram::BucketCount; ++bucket)
+            probes_[probe].Add(bucket, metrics.probes_[probe][bucket].load(std::memory_order_relaxed));
+    }
+
+    for (std::size_t counter = 0; counter < EventCounterCount; ++counter)
+        counters_[counter] += metrics.counters_[counter].load(std::memory_order_relaxed);
+}
+
+MetricsSnapshot TakeMetricsSnapshot()
+{
+    auto& registry = Registry();
+    std::lock_guard lock{ registry.mutex_ };
+    if (registry.threads_.empty())
+        return MetricsSnapshot{ };
+
+    MetricsSnapshot snapshot{ TicksPerNanosecond() };
+    for (const auto& metrics : registry.threads_)
+        snapshot.Collect(*metrics);
+    return snapshot;
+}
+
+void DumpMetrics(const MetricsSnapshot& snapshot, std::ostream& out)
+{
+    for (std::size_t index = 0; index < LatencyProbeCount; ++index)
+    {
+        auto probe = static_cast<LatencyProbe>(index);
+        if (snapshot.Samples(probe) == 0)
+            continue;
+
+        auto nanoseconds = [](double value) { return static_cast<std::uint64_t>(value + 0.5); };
+        out << ToString(probe)
+            << " count=" << snapshot.Samples(probe)
+            << " p50=" << nanoseconds(snapshot.PercentileNanoseconds(probe, 0.50)) << "ns"
+            << " p99=" << nanoseconds(snapshot.PercentileNanoseconds(probe, 0.99)) << "ns"
+            << " p99.9=" << nanoseconds(snapshot.PercentileNanoseconds(probe, 0.999)) << "ns"
+            << " max=" << nanoseconds(snapshot.MaxNanoseconds(probe)) << "ns\n";
+    }
+
+    for (std::size_t index = 0; index < EventCounterCount; ++index)
+    {
+        auto counter = static_cast<EventCounter>(index);
+        if (snapshot.Count(counter) != 0)
+            out << ToString(counter) << '=' << snapshot.Count(counter) << '\n';
+    }
+    out.flush();
+}
+
+PeriodicMetricsDump::PeriodicMetricsDump(std::chrono::milliseconds interval, std::ostream& out)
+{
+    thread_ = std::thread([this, interval, &out]
+        {
+            std::unique_lock lock{ mutex_ };
+            while (!wake_.wait_for(lock, interval, [this] { return stopping_; }))
+            {
+                lock.unlock();
+                DumpMetrics(TakeMetricsSnapshot(), out);
+                lock.lock();
+            }
+        });
+}
+
+PeriodicMetricsDump::~PeriodicMetricsDump()
+{
+    {
+        std::lock_guard lock{ mutex_ };
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
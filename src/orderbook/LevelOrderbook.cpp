@@ -0,0 +1,69 @@
+#include "internal/LevelOrderbook.h"
+
+#include <algorithm>
+#include <limits>
+
+LevelOrderbook::LevelOrderbook() { }
+
+LevelOrderbook::~LevelOrderbook() { }
+
+bool LevelOrderbook::SetLevel(Side side, Price price, Quantity quantity)
+{
+    if (!bids_.InRange(price))
+        return false;
+
+    if (quantity == 0)
+    {
+        ClearLevel(side, price);
+        return true;
+    }
+
+    auto& level = side == Side::Buy ? bids_[price] : asks_[price];
+    level.quantity_ = quantity;
+    return true;
+}
+
+void LevelOrderbook::ClearLevel(Side side, Price price)
+{
+    if (side == Side::Buy)
+        bids_.Erase(price);
+    else
+        asks_.Erase(price);
+}
+
+void LevelOrderbook::Clear()
+{
+    bids_.Clear();
+    asks_.Clear();
+}
+
+Quantity LevelOrderbook::GetLevel(Side side, Price price) const
+{
+    const Level* level = side == Side::Buy ? bids_.Find(price) : asks_.Find(price);
+    return level ? level->quantity_ : 0;
+}
+
+std::size_t LevelOrderbook::Size() const
+{
+    return bids_.Size() + asks_.Size();
+}
+
+OrderbookLevelInfos LevelOrderbook::GetOrderInfos() const
+{
+    return GetTopOfBook(std::numeric_limits<std::size_t>::max());
+}
+
+OrderbookLevelInfos LevelOrderbook::GetTopOfBook(std::size_t depth) const
+{
+    LevelInfos bidInfos, askInfos;
+    bidInfos.reserve(std::min(depth, bids_.Size()));
+    askInfos.reserve(std::min(depth, asks_.Size()));
+
+    bids_.ForEach([&](Price price, const Level& level)
+        { bidInfos.push_back(LevelInfo{ price, level.quantity_ }); }, depth);
+
+    asks_.ForEach([&](Price price, const Level& level)
+        { askInfos.push_back(LevelInfo{ price, level.quantity_ }); }, depth);
+
+    return OrderbookLevelInfos{ std::move(bidInfos), std::move(askInfos) };
+}
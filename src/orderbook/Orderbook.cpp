@@ -1,180 +1,616 @@
 #include "internal/Orderbook.h"
 
-# include <numeric>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 
-bool Orderbook::CanMatch(Side side, Price price) const
+#include "internal/DepthKernels.h"
+
+namespace
+{
+
+template <typename Ladder>
+constexpr bool HasDenseQuantities = requires (const Ladder& ladder) { ladder.Quantities(); };
+
+}
+
+template <typename Levels>
+bool BasicOrderbook<Levels>::CanMatch(Side side, Price price) const
 {
     if (side == Side::Buy)
     {
-        if (asks_.empty())
+        if (asks_.Empty())
             return false;
-        
-        const auto& [bestAsk, _] = *asks_.begin();
-        return price >= bestAsk;
+
+        return price >= asks_.BestPrice();
     }
     else
     {
-        if (bids_.empty())
+        if (bids_.Empty())
             return false;
-        
-        const auto& [bestBid, _] = *bids_.begin();
-        return price <= bestBid;
+
+        return price <= bids_.BestPrice();
     }
 }
 
-Trades Orderbook::MatchOrders()
+// Sums the aggregate quantity of the opposite levels the order could reach,
+// stopping as soon as it covers the order. A dense ladder sums the whole reach
+// with DepthKernels instead.
+template <typename Levels>
+bool BasicOrderbook<Levels>::CanFullyFill(Side side, Price price, Quantity quantity) const
 {
-    Trades trades;
-    trades.reserve(orders_.size());
-    
-    while (!bids_.empty() && !asks_.empty())
-    {
-        auto& [bidPrice, bids] = *bids_.begin();
-        auto& [askPrice, asks] = *asks_.begin();
-        
-        if (bidPrice < askPrice)
-            break;
-        
-        while (!bids.empty() && !asks.empty())
+    if constexpr (HasDenseQuantities<decltype(asks_)>)
+        return GetFillableQuantity(side, price) >= quantity;
+
+    std::uint64_t available = 0;
+    auto visit = [&](Price levelPrice, const Level& level)
+    {
+        if (side == Side::Buy ? levelPrice > price : levelPrice < price)
+            return false;
+        available += level.data_.quantity_;
+        return available < quantity;
+    };
+
+    if (side == Side::Buy)
+        asks_.ForEachWhile(visit);
+    else
+        bids_.ForEachWhile(visit);
+    return available >= quantity;
+}
+
+// The price of the furthest opposite level a market order for quantity would
+// reach, or of the last level if the book is too thin to fill it. A dense
+// ladder finds it with the sweep behind GetSweepCost.
+template <typename Levels>
+bool BasicOrderbook<Levels>::FindMarketPrice(Side side, Quantity quantity, Price& price) const
+{
+    if constexpr (HasDenseQuantities<decltype(asks_)>)
+    {
+        if (side == Side::Buy ? asks_.Empty() : bids_.Empty())
+            return false;
+        price = GetSweepCost(side, quantity).worstPrice_;
+        return true;
+    }
+
+    std::uint64_t available = 0;
+    bool found = false;
+    auto visit = [&](Price levelPrice, const Level& level)
+    {
+        price = levelPrice;
+        found = true;
+        available += level.data_.quantity_;
+        return available < quantity;
+    };
+
+    if (side == Side::Buy)
+        asks_.ForEachWhile(visit);
+    else
+        bids_.ForEachWhile(visit);
+    return found;
+}
+
+template <typename Levels>
+BasicOrderbook<Levels>::BasicOrderbook() { }
+
+template <typename Levels>
+BasicOrderbook<Levels>::BasicOrderbook(std::size_t capacityHint)
+    : orders_{ capacityHint }
+{ }
+
+template <typename Levels>
+BasicOrderbook<Levels>::~BasicOrderbook() { }
+
+// Runs the pre-checks of the order type against the book. Empty orders are
+// rejected, and a market order's price is replaced by the furthest level it
+// would reach.
+template <typename Levels>
+bool BasicOrderbook<Levels>::AdmitOrder(OrderType orderType, Side side, Price& price, Quantity quantity) const
+{
+    if (quantity == 0)
+        return false;
+
+    switch (orderType)
+    {
+    case OrderType::GoodTillCancel:
+        break;
+    case OrderType::FillAndKill:
+        if (!CanMatch(side, price))
+            return false;
+        break;
+    case OrderType::FillOrKill:
+        if (!CanFullyFill(side, price, quantity))
+            return false;
+        break;
+    case OrderType::PostOnly:
+        if (CanMatch(side, price))
+            return false;
+        break;
+    case OrderType::Market:
+        if (!FindMarketPrice(side, quantity, price))
+            return false;
+        break;
+    }
+
+    return bids_.InRange(price);
+}
+
+template <typename Levels>
+void BasicOrderbook<Levels>::LinkOrder(QueuedOrder* order)
+{
+    auto price = order->GetPrice();
+    TouchLevel(order->GetSide(), price);
+    auto& level = order->GetSide() == Side::Buy ? bids_[price] : asks_[price];
+    if (level.orders_.Empty())
+        MORNINGSIDE_COUNT(LevelsCreated, 1);
+    level.orders_.PushBack(order, chunks_);
+    level.data_.Apply(LevelData::Action::Add, order->GetRemainingQuantity());
+    SetLevelQuantity(order->GetSide(), price, level);
+}
+
+template <typename Levels>
+void BasicOrderbook<Levels>::UnlinkOrder(QueuedOrder* order)
+{
+    auto price = order->GetPrice();
+    TouchLevel(order->GetSide(), price);
+    if (order->GetSide() == Side::Sell)
+    {
+        auto& level = asks_.At(price);
+        level.orders_.Erase(order, chunks_);
+        level.data_.Apply(LevelData::Action::Remove, order->GetRemainingQuantity());
+        asks_.SetQuantity(price, level.data_.quantity_);
+        if (level.orders_.Empty())
         {
-            auto bid = bids.front();
-            auto ask = asks.front();
-            Quantity quantity = std::min(bid->GetRemainingQuantity(), ask->GetRemainingQuantity());
-            bid->Fill(quantity);
-            ask->Fill(quantity);
-            
-            if (bid->IsFilled())
-            {
-                bids.pop_front();
-                orders_.erase(bid->GetOrderId());
-            }
-            if (ask->IsFilled())
-            {
-                asks.pop_front();
-                orders_.erase(ask->GetOrderId());
-            }
-            
-            trades.push_back(Trade{
-                TradeInfo{ bid->GetOrderId(), bid->GetPrice(), quantity },
-                TradeInfo{ ask->GetOrderId(), ask->GetPrice(), quantity }
-            });
+            asks_.Erase(price);
+            MORNINGSIDE_COUNT(LevelsErased, 1);
         }
+    }
+    else
+    {
+        auto& level = bids_.At(price);
+        level.orders_.Erase(order, chunks_);
+        level.data_.Apply(LevelData::Action::Remove, order->GetRemainingQuantity());
+        bids_.SetQuantity(price, level.data_.quantity_);
+        if (level.orders_.Empty())
+        {
+            bids_.Erase(price);
+            MORNINGSIDE_COUNT(LevelsErased, 1);
+        }
+    }
+}
 
-        if (bids.empty())
-            bids_.erase(bidPrice);
-        if (asks.empty())
-            asks_.erase(askPrice);
+template <typename Levels>
+bool BasicOrderbook<Levels>::InsertOrder(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
+{
+    if (orders_.Contains(orderId) || !AdmitOrder(orderType, side, price, quantity))
+    {
+        MORNINGSIDE_COUNT(OrdersRejected, 1);
+        return false;
     }
-    
-    if (!bids_.empty())
+
+    QueuedOrder* order = pool_.Allocate(orderType, orderId, side, price, quantity);
+    LinkOrder(order);
+    orders_.Insert(orderId, order);
+    MORNINGSIDE_COUNT(OrdersAdded, 1);
+    return true;
+}
+
+// A same-price size-down is applied in place. Anything else unlinks the order
+// and relinks the same Order at the back of its new level, so the id index is
+// left alone unless the amended order is rejected.
+template <typename Levels>
+bool BasicOrderbook<Levels>::ModifyOrder(OrderId orderId, Side side, Price price, Quantity quantity)
+{
+    QueuedOrder* order = orders_.Find(orderId);
+    if (!order)
+        return false;
+
+    MORNINGSIDE_COUNT(OrdersModified, 1);
+    if (side == order->GetSide() && price == order->GetPrice() &&
+        quantity != 0 && quantity <= order->GetRemainingQuantity())
     {
-        auto& [_, bids] = *bids_.begin();
-        auto& order = bids.front();
-        if (order->GetOrderType() == OrderType::FillAndKill)
-            CancelOrder(order->GetOrderId());
+        auto reduction = order->GetRemainingQuantity() - quantity;
+        TouchLevel(side, price);
+        auto& level = side == Side::Buy ? bids_.At(price) : asks_.At(price);
+        order->Reduce(reduction);
+        level.data_.Apply(LevelData::Action::Reduce, reduction);
+        SetLevelQuantity(side, price, level);
+        return false;
     }
-    
-    if (!asks_.empty())
+
+    UnlinkOrder(order);
+    if (!AdmitOrder(order->GetOrderType(), side, price, quantity))
     {
-        auto& [_, asks] = *asks_.begin();
-        auto& order = asks.front();
-        if (order->GetOrderType() == OrderType::FillAndKill)
-            CancelOrder(order->GetOrderId());
+        MORNINGSIDE_COUNT(OrdersRejected, 1);
+        orders_.Erase(orderId);
+        pool_.Release(order);
+        return false;
     }
-    
+
+    order->Replace(side, price, quantity);
+    LinkOrder(order);
+    return true;
+}
+
+template <typename Levels>
+Trades BasicOrderbook<Levels>::AddOrder(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
+{
+    Trades trades;
+    AddOrder(orderType, orderId, side, price, quantity, [&trades](const Trade& trade) { trades.push_back(trade); });
     return trades;
 }
 
-Orderbook::Orderbook() { }
+template <typename Levels>
+Trades BasicOrderbook<Levels>::AddOrder(OrderPointer order)
+{
+    return AddOrder(order->GetOrderType(), order->GetOrderId(), order->GetSide(),
+        order->GetPrice(), order->GetRemainingQuantity());
+}
+
+template <typename Levels>
+void BasicOrderbook<Levels>::CancelOrder(OrderId orderId)
+{
+    MORNINGSIDE_PROBE(CancelOrder);
+
+    if (RemoveOrder(orderId))
+        FinishCommand();
+}
+
+template <typename Levels>
+bool BasicOrderbook<Levels>::RemoveOrder(OrderId orderId)
+{
+    QueuedOrder* order = orders_.Erase(orderId);
+    if (!order)
+        return false;
 
-Orderbook::~Orderbook() { }
+    UnlinkOrder(order);
+    pool_.Release(order);
+    MORNINGSIDE_COUNT(OrdersCancelled, 1);
+    return true;
+}
 
-Trades Orderbook::AddOrder(OrderPointer order)
+template <typename Levels>
+Trades BasicOrderbook<Levels>::MatchOrder(OrderModify order)
 {
-    if (orders_.contains(order->GetOrderId()))
-        return { };
-    
-    if (order->GetOrderType() == OrderType::FillAndKill && !CanMatch(order->GetSide(), order->GetPrice()))
-        return { };
-    
-    OrderPointers::iterator iterator;
+    Trades trades;
+    MatchOrder(order, [&trades](const Trade& trade) { trades.push_back(trade); });
+    return trades;
+}
 
-    if (order->GetSide() == Side::Buy)
-    {
-        auto& orders = bids_[order->GetPrice()];
-        orders.push_back(order);
-        iterator = std::prev(orders.end());
-    }
-    else
+template <typename Levels>
+Trades BasicOrderbook<Levels>::Apply(const OrderbookCommand& command)
+{
+    Trades trades;
+    ApplyBatch(std::span<const OrderbookCommand>{ &command, 1 }, trades);
+    return trades;
+}
+
+template <typename Levels>
+void BasicOrderbook<Levels>::ApplyBatch(std::span<const OrderbookCommand> commands, Trades& trades)
+{
+    trades.clear();
+    ApplyBatch(commands, [&trades](const Trade& trade) { trades.push_back(trade); });
+}
+
+template <typename Levels>
+void BasicOrderbook<Levels>::Reserve(std::size_t count)
+{
+    orders_.Reserve(count);
+}
+
+template <typename Levels>
+bool BasicOrderbook<Levels>::InsertRestoredOrder(OrderType orderType, OrderId orderId, Side side, Price price,
+    Quantity initialQuantity, Quantity remainingQuantity)
+{
+    if (remainingQuantity == 0 || remainingQuantity > initialQuantity)
+        return false;
+
+    if (!bids_.InRange(price) || orders_.Contains(orderId))
+        return false;
+
+    QueuedOrder* order = pool_.Allocate(orderType, orderId, side, price, initialQuantity);
+    order->Fill(initialQuantity - remainingQuantity);
+    LinkOrder(order);
+    orders_.Insert(orderId, order);
+    return true;
+}
+
+template <typename Levels>
+bool BasicOrderbook<Levels>::RestoreOrder(OrderType orderType, OrderId orderId, Side side, Price price,
+    Quantity initialQuantity, Quantity remainingQuantity)
+{
+    if (!InsertRestoredOrder(orderType, orderId, side, price, initialQuantity, remainingQuantity))
+        return false;
+
+    FinishCommand();
+    return true;
+}
+
+template <typename Levels>
+bool BasicOrderbook<Levels>::RestoreOrders(std::span<const Order> orders)
+{
+    orders_.Reserve(orders_.Size() + orders.size());
+    for (std::size_t restored = 0; restored < orders.size(); ++restored)
     {
-        auto& orders = asks_[order->GetPrice()];
-        orders.push_back(order);
-        iterator = std::prev(orders.end());
+        const Order& order = orders[restored];
+        if (InsertRestoredOrder(order.GetOrderType(), order.GetOrderId(), order.GetSide(), order.GetPrice(),
+                order.GetInitialQuantity(), order.GetRemainingQuantity()))
+            continue;
+
+        // Back to front, so each order is still at the back of its level.
+        while (restored-- > 0)
+        {
+            QueuedOrder* queued = orders_.Erase(orders[restored].GetOrderId());
+            UnlinkOrder(queued);
+            pool_.Release(queued);
+        }
+        FinishCommand();
+        return false;
     }
 
-    orders_.insert({ order->GetOrderId(), OrderEntry{ order, iterator }});
-    return MatchOrders();
+    FinishCommand();
+    return true;
 }
 
-void Orderbook::CancelOrder(OrderId orderId)
+template <typename Levels>
+void BasicOrderbook<Levels>::SetDepthPublisher(DepthPublisher* publisher)
 {
-    if (!orders_.contains(orderId))
-        return;
-    
-    const auto [order, iterator] = orders_.at(orderId);
-    orders_.erase(orderId);
+    depthPublisher_ = publisher;
+    bidDepthBound_ = std::numeric_limits<Price>::max();
+    askDepthBound_ = std::numeric_limits<Price>::min();
+    depthDirty_ = publisher != nullptr;
+    PublishDepth();
+}
 
-    if (order->GetSide() == Side::Sell)
+template <typename Levels>
+void BasicOrderbook<Levels>::SetLevelChangeListener(LevelChangeListener* listener)
+{
+    levelListener_ = listener;
+    levelChanges_.clear();
+    levelChanges_.reserve(64);
+}
+
+template <typename Levels>
+void BasicOrderbook<Levels>::RecordLevel(Side side, Price price)
+{
+    for (auto it = levelChanges_.rbegin(); it != levelChanges_.rend(); ++it)
     {
-        auto price = order->GetPrice();
-        auto& orders = asks_.at(price);
-        orders.erase(iterator);
-        if (orders.empty())
-            asks_.erase(price);
+        if (it->price_ == price && it->side_ == side)
+            return;
     }
-    else
+
+    const Level* level = side == Side::Buy ? bids_.Find(price) : asks_.Find(price);
+    levelChanges_.push_back(LevelChange{ side, price,
+        level ? level->data_.quantity_ : Quantity{ }, level ? level->data_.count_ : Quantity{ } });
+}
+
+template <typename Levels>
+void BasicOrderbook<Levels>::WriteLevelChanges()
+{
+    std::size_t changed = 0;
+    for (const auto& before : levelChanges_)
     {
-        auto price = order->GetPrice();
-        auto& orders = bids_.at(price);
-        orders.erase(iterator);
-        if (orders.empty())
-            bids_.erase(price);
+        const Level* level = before.side_ == Side::Buy ? bids_.Find(before.price_) : asks_.Find(before.price_);
+        LevelChange after{ before.side_, before.price_,
+            level ? level->data_.quantity_ : Quantity{ }, level ? level->data_.count_ : Quantity{ } };
+        if (after.quantity_ != before.quantity_ || after.count_ != before.count_)
+            levelChanges_[changed++] = after;
     }
+
+    if (changed > 0)
+        levelListener_->OnLevelChanges({ levelChanges_.data(), changed });
+    levelChanges_.clear();
 }
 
-Trades Orderbook::MatchOrder(OrderModify order)
+template <typename Levels>
+void BasicOrderbook<Levels>::WriteDepth()
 {
-    if (!orders_.contains(order.GetOrderId()))
-        return { };
-    
-    OrderType orderType = orders_.at(order.GetOrderId()).order_->GetOrderType();
-    CancelOrder(order.GetOrderId());
-    return AddOrder(order.ToOrderPointer(orderType));
+    std::array<LevelInfo, MaxPublishedDepth> bids, asks;
+    std::size_t bidCount = 0, askCount = 0;
+    auto depth = depthPublisher_->Depth();
+
+    bids_.ForEach([&](Price price, const Level& level)
+        { bids[bidCount++] = LevelInfo{ price, level.data_.quantity_ }; }, depth);
+
+    asks_.ForEach([&](Price price, const Level& level)
+        { asks[askCount++] = LevelInfo{ price, level.data_.quantity_ }; }, depth);
+
+    depthPublisher_->Publish({ bids.data(), bidCount }, { asks.data(), askCount });
+    bidDepthBound_ = bidCount == depth ? bids[depth - 1].price_ : std::numeric_limits<Price>::min();
+    askDepthBound_ = askCount == depth ? asks[depth - 1].price_ : std::numeric_limits<Price>::max();
+    depthDirty_ = false;
+}
+
+template <typename Levels>
+std::size_t BasicOrderbook<Levels>::Size() const
+{
+    return orders_.Size();
 }
 
-std::size_t Orderbook::Size() const
+template <typename Levels>
+OrderbookLevelInfos BasicOrderbook<Levels>::GetOrderInfos() const
 {
-    return orders_.size();
+    return GetTopOfBook(std::numeric_limits<std::size_t>::max());
 }
 
-OrderbookLevelInfos Orderbook::GetOrderInfos() const
+template <typename Levels>
+OrderbookLevelInfos BasicOrderbook<Levels>::GetTopOfBook(std::size_t depth) const
 {
     LevelInfos bidInfos, askInfos;
-    bidInfos.reserve(orders_.size());
-    askInfos.reserve(orders_.size());
+    bidInfos.reserve(std::min(depth, bids_.Size()));
+    askInfos.reserve(std::min(depth, asks_.Size()));
 
-    auto CreateLevelInfos = [](Price price, const OrderPointers& orders)
+    bids_.ForEach([&](Price price, const Level& level)
+        { bidInfos.push_back(LevelInfo{ price, level.data_.quantity_ }); }, depth);
+
+    asks_.ForEach([&](Price price, const Level& level)
+        { askInfos.push_back(LevelInfo{ price, level.data_.quantity_ }); }, depth);
+
+    return OrderbookLevelInfos{ std::move(bidInfos), std::move(askInfos) };
+}
+
+template <typename Levels>
+std::uint64_t BasicOrderbook<Levels>::GetFillableQuantity(Side side, Price price) const
+{
+    auto fillable = [&](const auto& levels) -> std::uint64_t
     {
-        return LevelInfo{ price, std::accumulate(orders.begin(), orders.end(), (Quantity)0,
-            [](Quantity runningSum, const OrderPointer& order)
-            { return runningSum + order->GetRemainingQuantity(); }) };
+        using Ladder = std::remove_cvref_t<decltype(levels)>;
+        if constexpr (HasDenseQuantities<Ladder>)
+        {
+            if (levels.Empty())
+                return 0;
+
+            // The ticks from the best level to price, if price reaches it.
+            auto quantities = levels.Quantities();
+            auto best = std::int64_t{ levels.BestPrice() } - Ladder::FirstPrice;
+            auto limit = std::int64_t{ price } - Ladder::FirstPrice;
+            auto low = side == Side::Buy ? best : std::max<std::int64_t>(limit, 0);
+            auto high = side == Side::Buy ? std::min<std::int64_t>(limit, quantities.size() - 1) : best;
+            if (low > high)
+                return 0;
+            return DepthKernels::Best().sum_(quantities.subspan(low, high - low + 1));
+        }
+        else
+        {
+            std::uint64_t available = 0;
+            levels.ForEachWhile([&](Price levelPrice, const Level& level)
+            {
+                if (side == Side::Buy ? levelPrice > price : levelPrice < price)
+                    return false;
+                available += level.data_.quantity_;
+                return true;
+            });
+            return available;
+        }
     };
 
-    for (const auto& [price, orders] : bids_)
-        bidInfos.push_back(CreateLevelInfos(price, orders));
+    return side == Side::Buy ? fillable(asks_) : fillable(bids_);
+}
+
+// The dense walk starts at the best level rather than the end of the range.
+template <typename Levels>
+SweepCost BasicOrderbook<Levels>::GetSweepCost(Side side, std::uint64_t quantity) const
+{
+    auto sweep = [&](const auto& levels) -> SweepCost
+    {
+        using Ladder = std::remove_cvref_t<decltype(levels)>;
+        if (levels.Empty())
+            return SweepCost{ };
+
+        if constexpr (HasDenseQuantities<Ladder>)
+        {
+            auto quantities = levels.Quantities();
+            auto best = static_cast<std::size_t>(levels.BestPrice() - Ladder::FirstPrice);
+            if (side == Side::Buy)
+            {
+                auto taken = DepthKernels::Best().sweepForward_(quantities.subspan(best), quantity);
+                return SweepCost{ taken.quantity_,
+                    std::int64_t{ levels.BestPrice() } * static_cast<std::int64_t>(taken.quantity_) +
+                        static_cast<std::int64_t>(taken.weightedOffset_),
+                    levels.BestPrice() + static_cast<Price>(taken.lastOffset_) };
+            }
+            else
+            {
+                auto taken = DepthKernels::Best().sweepBackward_(quantities.first(best + 1), quantity);
+                return SweepCost{ taken.quantity_,
+                    std::int64_t{ levels.BestPrice() } * static_cast<std::int64_t>(taken.quantity_) -
+                        static_cast<std::int64_t>(taken.weightedOffset_),
+                    levels.BestPrice() - static_cast<Price>(taken.lastOffset_) };
+            }
+        }
+        else
+        {
+            SweepCost cost;
+            levels.ForEachWhile([&](Price levelPrice, const Level& level)
+            {
+                auto taken = std::min<std::uint64_t>(level.data_.quantity_, quantity - cost.quantity_);
+                cost.quantity_ += taken;
+                cost.notional_ += std::int64_t{ levelPrice } * static_cast<std::int64_t>(taken);
+                cost.worstPrice_ = levelPrice;
+                return cost.quantity_ < quantity;
+            });
+            return cost;
+        }
+    };
 
-    for (const auto& [price, orders] : asks_)
-        askInfos.push_back(CreateLevelInfos(price, orders));
+    return side == Side::Buy ? sweep(asks_) : sweep(bids_);
+}
+
+// A buyer at a tick reaches every ask at or below it, so buy depth is a running
+// total up the ask prices and sell depth one down the bid prices. The dense
+// version scans the ticks the ladder shares with depth, carrying in the levels
+// beyond them, and fills the ticks outside the ladder with zero or the total.
+template <typename Levels>
+void BasicOrderbook<Levels>::GetCumulativeDepth(Side side, Price first, std::span<std::uint64_t> depth) const
+{
+    auto count = static_cast<std::int64_t>(depth.size());
+    auto cumulate = [&](const auto& levels)
+    {
+        using Ladder = std::remove_cvref_t<decltype(levels)>;
+        if constexpr (HasDenseQuantities<Ladder>)
+        {
+            const auto& kernels = DepthKernels::Best();
+            auto quantities = levels.Quantities();
+            auto size = static_cast<std::int64_t>(quantities.size());
+            auto offset = std::int64_t{ first } - Ladder::FirstPrice;
+            auto low = std::clamp<std::int64_t>(offset, 0, size);
+            auto high = std::clamp<std::int64_t>(offset + count, 0, size);
+            auto below = std::clamp<std::int64_t>(-offset, 0, count);
+            auto above = count - below - (high - low);
+            auto shared = quantities.subspan(low, high - low);
+            std::uint64_t* sums = depth.data() + below;
+
+            if (side == Side::Buy)
+            {
+                auto carry = kernels.sum_(quantities.first(low));
+                kernels.prefixSums_(shared, sums, carry);
+                std::fill_n(depth.data(), below, 0);
+                std::fill_n(sums + shared.size(), above, shared.empty() ? carry : sums[shared.size() - 1]);
+            }
+            else
+            {
+                auto carry = kernels.sum_(quantities.subspan(high));
+                kernels.suffixSums_(shared, sums, carry);
+                std::fill_n(depth.data(), below, shared.empty() ? carry : sums[0]);
+                std::fill_n(sums + shared.size(), above, 0);
+            }
+        }
+        else
+        {
+            std::uint64_t total = 0;
+            if (side == Side::Buy)
+            {
+                std::int64_t tick = 0;
+                levels.ForEachWhile([&](Price levelPrice, const Level& level)
+                {
+                    for (; tick < count && first + tick < levelPrice; ++tick)
+                        depth[tick] = total;
+                    total += level.data_.quantity_;
+                    return tick < count;
+                });
+                std::fill(depth.begin() + tick, depth.end(), total);
+            }
+            else
+            {
+                std::int64_t tick = count;
+                levels.ForEachWhile([&](Price levelPrice, const Level& level)
+                {
+                    for (; tick > 0 && first + tick - 1 > levelPrice; --tick)
+                        depth[tick - 1] = total;
+                    total += level.data_.quantity_;
+                    return tick > 0;
+                });
+                std::fill(depth.begin(), depth.begin() + tick, total);
+            }
+        }
+    };
+
+    if (side == Side::Buy)
+        cumulate(asks_);
+    else
+        cumulate(bids_);
+}
 
-    return OrderbookLevelInfos{ bidInfos, askInfos };
-}
\ No newline at end of file
+template class BasicOrderbook<MapLevels>;
+template class BasicOrderbook<ArrayLevels<>>;
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "internal/OrderbookManager.h"
+#include "internal/ThreadAffinity.h"
+
+#include <stdexcept>
+
+template <typename Levels>
+BasicOrderbookManager<Levels>::BasicOrderbookManager(std::size_t shardCount, bool pinThreads)
+    : pinThreads_{ pinThreads }
+{
+    if (shardCount == 0)
+        throw std::invalid_argument("OrderbookManager needs at least one shard.");
+
+    shards_.reserve(shardCount);
+    for (std::size_t i = 0; i < shardCount; ++i)
+        shards_.push_back(std::make_unique<Shard>());
+}
+
+template <typename Levels>
+BasicOrderbookManager<Levels>::~BasicOrderbookManager()
+{
+    Stop();
+}
+
+template <typename Levels>
+MarketId BasicOrderbookManager<Levels>::AddMarket(const std::string& ticker, std::size_t capacityHint)
+{
+    if (running_)
+        throw std::logic_error("Markets cannot be added while the manager is running.");
+
+    auto [iterator, inserted] = marketIds_.try_emplace(ticker, static_cast<MarketId>(orderbooks_.size()));
+    if (inserted)
+        orderbooks_.push_back(std::make_unique<OrderbookType>(capacityHint));
+    return iterator->second;
+}
+
+template <typename Levels>
+MarketId BasicOrderbookManager<Levels>::GetMarketId(const std::string& ticker) const
+{
+    return marketIds_.at(ticker);
+}
+
+template <typename Levels>
+void BasicOrderbookManager<Levels>::Start()
+{
+    if (running_)
+        return;
+
+    running_ = true;
+    for (std::size_t i = 0; i < shards_.size(); ++i)
+        shards_[i]->thread_ = std::thread([this, i] { Run(i); });
+}
+
+template <typename Levels>
+void BasicOrderbookManager<Levels>::Stop()
+{
+    if (!running_)
+        return;
+
+    for (auto& shard : shards_)
+    {
+        {
+            std::lock_guard lock{ shard->mutex_ };
+            shard->stopping_ = true;
+        }
+        shard->ready_.notify_one();
+    }
+
+    for (auto& shard : shards_)
+    {
+        shard->thread_.join();
+        shard->stopping_ = false;
+    }
+    running_ = false;
+}
+
+template <typename Levels>
+void BasicOrderbookManager<Levels>::Enqueue(Shard& shard, std::span<const MarketCommand> commands)
+{
+    bool wake = false;
+    {
+        std::lock_guard lock{ shard.mutex_ };
+        wake = shard.pending_.empty();
+        shard.pending_.insert(shard.pending_.end(), commands.begin(), commands.end());
+        shard.submitted_ += commands.size();
+    }
+    if (wake)
+        shard.ready_.notify_one();
+}
+
+template <typename Levels>
+void BasicOrderbookManager<Levels>::Submit(const MarketCommand& command)
+{
+    Enqueue(*shards_[ShardOf(command.marketId_)], { &command, 1 });
+}
+
+// Buckets the batch by shard in one stable counting pass, so each shard's
+// commands keep their order and only shards that receive work are locked.
+template <typename Levels>
+void BasicOrderbookManager<Levels>::Submit(std::span<const MarketCommand> commands)
+{
+    if (commands.empty())
+        return;
+    if (commands.size() == 1 || shards_.size() == 1)
+    {
+        Enqueue(*shards_[ShardOf(commands.front().marketId_)], commands);
+        return;
+    }
+
+    thread_local std::vector<std::size_t> offsets;
+    thread_local std::vector<MarketCommand> bucketed;
+    offsets.assign(shards_.size() + 1, 0);
+    for (const auto& command : commands)
+        ++offsets[ShardOf(command.marketId_) + 1];
+    for (std::size_t shardIndex = 0; shardIndex < shards_.size(); ++shardIndex)
+        offsets[shardIndex + 1] += offsets[shardIndex];
+
+    bucketed.resize(commands.size());
+    for (const auto& command : commands)
+        bucketed[offsets[ShardOf(command.marketId_)]++] = command;
+
+    // Each offset now marks the end of its shard's bucket.
+    std::size_t begin = 0;
+    for (std::size_t shardIndex = 0; shardIndex < shards_.size(); ++shardIndex)
+    {
+        std::size_t end = offsets[shardIndex];
+        if (end > begin)
+            Enqueue(*shards_[shardIndex], std::span<const MarketCommand>{ bucketed }.subspan(begin, end - begin));
+        begin = end;
+    }
+}
+
+template <typename Levels>
+void BasicOrderbookManager<Levels>::Drain()
+{
+    for (auto& shard : shards_)
+    {
+        std::unique_lock lock{ shard->mutex_ };
+        shard->drained_.wait(lock, [&] { return !running_ || shard->processed_ == shard->submitted_; });
+    }
+}
+
+template <typename Levels>
+std::uint64_t BasicOrderbookManager<Levels>::TradeCount() const
+{
+    std::uint64_t trades = 0;
+    for (const auto& shard : shards_)
+        trades += shard->tradeCount_.load(std::memory_order_relaxed);
+    return trades;
+}
+
+template <typename Levels>
+void BasicOrderbookManager<Levels>::Run(std::size_t shardIndex)
+{
+    Shard& shard = *shards_[shardIndex];
+
+    if (pinThreads_)
+        PinCurrentThread(shardIndex);
+
+    for (;;)
+    {
+        {
+            std::unique_lock lock{ shard.mutex_ };
+            shard.ready_.wait(lock, [&] { return shard.stopping_ || !shard.pending_.empty(); });
+            if (shard.pending_.empty())
+                return;
+            std::swap(shard.pending_, shard.batch_);
+        }
+
+        const auto& batch = shard.batch_;
+        for (std::size_t begin = 0; begin < batch.size(); )
+        {
+            auto marketId = batch[begin].marketId_;
+            auto end = begin + 1;
+            while (end < batch.size() && batch[end].marketId_ == marketId)
+                ++end;
+            Apply(shard, marketId, std::span{ batch }.subspan(begin, end - begin));
+            begin = end;
+        }
+
+        {
+            std::lock_guard lock{ shard.mutex_ };
+            shard.processed_ += shard.batch_.size();
+        }
+        shard.drained_.notify_all();
+        shard.batch_.clear();
+    }
+}
+
+// Hands a run of commands for one market to its book as a single batch, so the
+// index reservation and the depth publish happen once per run.
+template <typename Levels>
+void BasicOrderbookManager<Levels>::Apply(Shard& shard, MarketId marketId, std::span<const MarketCommand> commands)
+{
+    if (marketId >= orderbooks_.size())
+        return;
+
+    shard.run_.clear();
+    for (const auto& command : commands)
+        shard.run_.push_back(command.command_);
+
+    std::uint64_t trades = 0;
+    orderbooks_[marketId]->ApplyBatch(shard.run_, [&trades](const Trade&) { ++trades; });
+    if (trades > 0)
+        shard.tradeCount_.fetch_add(trades, std::memory_order_relaxed);
+}
+
+template class BasicOrderbookManager<MapLevels>;
+template class BasicOrderbookManager<ArrayLevels<>>;
@@ -0,0 +1,92 @@
+#include "internal/OrderbookWorker.h"
+#include "internal/ThreadAffinity.h"
+
+#include <array>
+
+template <typename Levels>
+BasicOrderbookWorker<Levels>::BasicOrderbookWorker(std::size_t ringCapacity, std::size_t capacityHint)
+    : orderbook_{ capacityHint }
+    , commands_{ ringCapacity }
+    , trades_{ ringCapacity }
+{ }
+
+template <typename Levels>
+BasicOrderbookWorker<Levels>::~BasicOrderbookWorker()
+{
+    Stop();
+}
+
+template <typename Levels>
+void BasicOrderbookWorker<Levels>::Start(int cpu)
+{
+    if (thread_.joinable())
+        return;
+
+    stopping_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this, cpu] { Run(cpu); });
+}
+
+template <typename Levels>
+void BasicOrderbookWorker<Levels>::Stop()
+{
+    if (!thread_.joinable())
+        return;
+
+    stopping_.store(true, std::memory_order_release);
+    thread_.join();
+}
+
+template <typename Levels>
+void BasicOrderbookWorker<Levels>::Submit(const OrderbookCommand& command)
+{
+    while (!commands_.TryPush(command))
+        std::this_thread::yield();
+}
+
+template <typename Levels>
+void BasicOrderbookWorker<Levels>::Run(int cpu)
+{
+    if (cpu >= 0)
+        PinCurrentThread(static_cast<std::size_t>(cpu));
+
+    std::array<OrderbookCommand, BatchSize> batch;
+    for (;;)
+    {
+        std::size_t count = 0;
+        while (count < batch.size() && commands_.TryPop(batch[count]))
+            ++count;
+
+        if (count > 0)
+        {
+            orderbook_.ApplyBatch(std::span<const OrderbookCommand>{ batch.data(), count },
+                [this](const Trade& trade) { Publish(trade); });
+            continue;
+        }
+
+        if (stopping_.load(std::memory_order_acquire))
+        {
+            if (commands_.Empty())
+                return;
+            continue;
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+template <typename Levels>
+void BasicOrderbookWorker<Levels>::Publish(const Trade& trade)
+{
+    while (!trades_.TryPush(trade))
+    {
+        if (stopping_.load(std::memory_order_acquire))
+        {
+            droppedTrades_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+template class BasicOrderbookWorker<MapLevels>;
+template class BasicOrderbookWorker<ArrayLevels<>>;
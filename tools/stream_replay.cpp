@@ -0,0 +1,123 @@
+#include "internal/MarketDataFeedHandler.h"
+
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+// Quantity per cent as the venue reports it: yes levels from the bids, no
+// levels from the asks at the complementary price.
+struct StreamLevels {
+    std::array<Quantity, KalshiMaxPrice + 1> yes{};
+    std::array<Quantity, KalshiMaxPrice + 1> no{};
+};
+
+template <typename OrderbookType>
+StreamLevels readLevels(const OrderbookType& orderbook) {
+    StreamLevels levels;
+    OrderbookLevelInfos infos = orderbook.GetOrderInfos();
+    for (const auto& level : infos.GetBids()) {
+        levels.yes[level.price_] = level.quantity_;
+    }
+    for (const auto& level : infos.GetAsks()) {
+        levels.no[100 - level.price_] = level.quantity_;
+    }
+    return levels;
+}
+
+// Reports every cent where the book differs from the handler's mirror.
+template <typename OrderbookType>
+bool matchesMirror(const OrderbookType& orderbook, const StreamSubscription& subscription,
+                   const std::string& ticker, const char* kind, std::size_t line) {
+    StreamLevels levels = readLevels(orderbook);
+    bool matches = true;
+    for (Price price = KalshiMinPrice; price <= KalshiMaxPrice; ++price) {
+        if (levels.yes[price] != subscription.yes[price] || levels.no[price] != subscription.no[price]) {
+            std::cerr << "Line " << line << ": " << kind << " book for " << ticker << " at " << price
+                      << "¢ holds yes " << levels.yes[price] << " / no " << levels.no[price]
+                      << ", stream has yes " << subscription.yes[price] << " / no " << subscription.no[price]
+                      << std::endl;
+            matches = false;
+        }
+    }
+    return matches;
+}
+
+// Feeds recorded stream messages, one JSON message per line, through the
+// handler into both an Orderbook and a LevelOrderbook per ticker, and checks
+// after every message that each book holds exactly the levels the stream does.
+int replay(const std::vector<std::string>& messages, const std::set<std::string>& tickers) {
+    MarketDataFeedHandler orderbookFeed;
+    MarketDataFeedHandler levelFeed;
+    std::vector<Orderbook> orderbooks(tickers.size());
+    std::vector<LevelOrderbook> levelOrderbooks(tickers.size());
+
+    std::size_t index = 0;
+    for (const auto& ticker : tickers) {
+        orderbookFeed.attachOrderbook(ticker, orderbooks[index]);
+        levelFeed.attachOrderbook(ticker, levelOrderbooks[index]);
+        ++index;
+    }
+
+    std::size_t mismatches = 0;
+    for (std::size_t line = 0; line < messages.size(); ++line) {
+        // A gap asks the venue for a new snapshot, which fails without a
+        // connection. The book is still marked unsynced, which is what the
+        // recording goes on to check.
+        orderbookFeed.handleStreamMessage(messages[line]);
+        levelFeed.handleStreamMessage(messages[line]);
+
+        index = 0;
+        for (const auto& ticker : tickers) {
+            const StreamSubscription* orderbookMirror = orderbookFeed.findStreamSubscription(ticker);
+            const StreamSubscription* levelMirror = levelFeed.findStreamSubscription(ticker);
+            if (!matchesMirror(orderbooks[index], *orderbookMirror, ticker, "Orderbook", line + 1) ||
+                !matchesMirror(levelOrderbooks[index], *levelMirror, ticker, "LevelOrderbook", line + 1) ||
+                orderbookMirror->yes != levelMirror->yes || orderbookMirror->no != levelMirror->no) {
+                ++mismatches;
+            }
+            ++index;
+        }
+    }
+
+    std::cout << "Messages: " << messages.size() << std::endl;
+    std::cout << "Tickers: " << tickers.size() << std::endl;
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <recorded messages>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> messages;
+    std::set<std::string> tickers;
+    try {
+        std::string line;
+        while (std::getline(input, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            json message = json::parse(line);
+            if (message.contains("msg") && message["msg"].contains("market_ticker")) {
+                tickers.insert(message["msg"]["market_ticker"].get<std::string>());
+            }
+            messages.push_back(std::move(line));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to read recording: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return replay(messages, tickers);
+}